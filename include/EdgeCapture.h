@@ -0,0 +1,131 @@
+//---------------------------Sensor Edge Capture-----------------------------
+// Captures every change on the detector inputs from interrupt context, so
+// an edge is never missed or seen late just because the main loop is busy
+// (a display transfer, a long task, etc).
+//
+//   Producer - the pin change ISR (and, for ports without pin change
+//   interrupts, a 1ms timer ISR that samples them) reads the port's
+//   input register once, compares it with the last reading and pushes
+//   a raw (sensor, level, micros) event for each sensor bit that
+//   changed into a single-producer/single-consumer ring buffer.  AVR
+//   interrupts do not nest, so all ISRs together are one producer.
+//
+//   Consumer - update() drains the ring from the sensor task and debounces
+//   on the timestamps: a new level is accepted once it has been stable for
+//   the sensor's debounce window, and the accepted edge keeps the time of
+//   the first transition, not the time it was noticed.  Accepted edges
+//   come out of nextEdge() oldest first, across all pins.
+//
+//   If the ring fills, the ISR drops the event but has already moved on
+//   to the new level, so a pin's last transition can be lost for good.
+//   update() then reads the ports back and debounces every pin whose
+//   live level is not its stable one from that moment.
+//
+//   If the sensor task falls so far behind that the accepted edges
+//   overfill their ring, the oldest is dropped and edgeOverruns() goes
+//   up.  The dropped edge still sets read(), so a caller that sees the
+//   count change brings its view of each sensor back in line from read().
+//
+// Each sensor's window adapts to the sensor.  A new level that falls back
+// before its window is up is a glitch; the window is BOUNCE_MARGIN times
+// the longest glitch the sensor has shown lately, kept between the
+// minimum and maximum given to begin().  Every edge accepted without a
+// glitch takes an eighth off that longest glitch, so a clean sensor
+// comes down to the minimum and reacts sooner, and one whose contacts or
+// optics have started to bounce gets a longer window before its glitches
+// turn into edges.  glitches() and window() are there for the health
+// monitor (SensorHealth.h).
+//
+// The sensors are given as CapturePorts - a port, the bits on it that
+// carry sensors and which sensor each bit is - normally worked out at
+// compile time by SensorBank (SensorPair.h).  PORTB (PCINT0) and PORTK,
+// A8-A15 (PCINT2) have pin change interrupts.  Pin 9 (revSensOut) is on
+// PH6 which has no pin change interrupt on the Mega 2560, so PORTH is
+// sampled by the timer ISR instead; its edge times are accurate to about
+// 1ms.  A sensor on no port (a yard without a reverse loop) never
+// changes: it reads HIGH, clear.
+//---------------------------------------------------------------------------
+
+#ifndef EDGECAPTURE_H
+#define EDGECAPTURE_H
+
+#include "Hal.h"
+
+struct CapturePort
+{
+  byte port;                   //---MegaPort (MegaPins.h)
+  byte mask;                   //---bits that carry a sensor
+  byte sensor[8];              //---sensor index of each bit
+};
+
+struct SensorEdge
+{
+  byte          index : 7;     //---sensor number, as in the CapturePorts
+  byte          level : 1;     //---new debounced level, active low
+  unsigned long us;            //---micros() of the first transition
+};
+
+class EdgeCapture
+{
+  public:
+    enum { MAX_SENSORS = 16, MAX_PORTS = 4, RAW_SIZE = 32, EDGE_SIZE = 16,
+           BOUNCE_MARGIN = 4 };
+
+    //---every window starts at debounceUs and stays within minUs..maxUs
+    void begin(const CapturePort *portList, byte portCount, byte sensorCount,
+               unsigned long debounceUs, unsigned long minUs, unsigned long maxUs);
+
+    void update();                  //---drain raw events, debounce them
+    bool nextEdge(SensorEdge &e);   //---oldest accepted edge, if any
+    byte read(byte index) const { return state[index].applied; }   //---as of nextEdge()
+    unsigned long window(byte index) const;
+    uint16_t glitches(byte index) const { return state[index].glitches; }
+
+    //---optional tap on every raw event as it is drained, before debounce
+    void onRaw(void (*hook)(byte index, byte level, unsigned long us))
+      { rawHook = hook; }
+
+    unsigned long rawOverruns() const  { return rawLost; }
+    unsigned long edgeOverruns() const { return edgeLost; }
+
+    //---producer side, called from interrupt context only
+    void capture(byte index, byte level, unsigned long us);
+
+  private:
+    struct RawEdge { byte indexLevel; unsigned long us; };
+    struct PinState
+    {
+      byte          stable : 1;
+      byte          pending : 1;
+      byte          hasPending : 1;
+      byte          applied : 1;       //---level as of the last nextEdge()
+      byte          glitched : 1;      //---a glitch since the last edge
+      unsigned long pendingSince;
+      uint16_t      longestGlitch;     //---us, lately
+      uint16_t      glitches;          //---since begin(), stops at 65535
+    };
+
+    void process(byte index, byte level, unsigned long us);
+    void acceptDue(unsigned long now);
+    void resync(unsigned long now);    //---after a raw overrun
+
+    void        (*rawHook)(byte index, byte level, unsigned long us);
+    byte          sensorCount;
+    unsigned long minWindow, maxWindow;
+    PinState      state[MAX_SENSORS];
+
+    RawEdge       raw[RAW_SIZE];
+    volatile byte rawHead, rawTail;
+    volatile unsigned long rawLost;
+    unsigned long rawSeen;             //---rawLost as of the last resync()
+
+    SensorEdge    edges[EDGE_SIZE];
+    byte          edgeHead, edgeTail;
+    unsigned long edgeLost;
+};
+
+static_assert(EdgeCapture::MAX_SENSORS <= 128, "SensorEdge::index is 7 bits");
+
+extern EdgeCapture edgeCapture;
+
+#endif
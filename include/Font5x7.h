@@ -0,0 +1,80 @@
+//---------------------------5x7 Panel Font----------------------------------
+// The classic 5x7 glyphs used by Adafruit_GFX's built-in font, printable
+// ASCII only (0x20..0x7E).  Each glyph is 5 column bytes, least significant
+// bit at the top; characters are drawn in a 6x8 cell, times the text size.
+//
+// The sketch draws the track and yard fields with it a page at a time
+// (ScreenLayout.h), and tools/render_screens.py reads this table to
+// pre-render the fixed screens.
+//---------------------------------------------------------------------------
+
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+#include "Hal.h"
+
+#define FONT5X7_FIRST  0x20
+#define FONT5X7_LAST   0x7E
+#define FONT5X7_WIDTH  5
+#define FONT5X7_CELL_W 6
+#define FONT5X7_CELL_H 8
+
+static const uint8_t font5x7[][FONT5X7_WIDTH] PROGMEM = {
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00},  // ' ' !
+  {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},  // " #
+  {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62},  // $ %
+  {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},  // & '
+  {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00},  // ( )
+  {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},  // * +
+  {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08},  // , -
+  {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},  // . /
+  {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00},  // 0 1
+  {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},  // 2 3
+  {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39},  // 4 5
+  {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},  // 6 7
+  {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E},  // 8 9
+  {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},  // : ;
+  {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14},  // < =
+  {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},  // > ?
+  {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C},  // @ A
+  {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},  // B C
+  {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41},  // D E
+  {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},  // F G
+  {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00},  // H I
+  {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},  // J K
+  {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F},  // L M
+  {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},  // N O
+  {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E},  // P Q
+  {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},  // R S
+  {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F},  // T U
+  {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},  // V W
+  {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03},  // X Y
+  {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},  // Z [
+  {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F},  // \ ]
+  {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},  // ^ _
+  {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40},  // ` a
+  {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},  // b c
+  {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18},  // d e
+  {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},  // f g
+  {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00},  // h i
+  {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},  // j k
+  {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78},  // l m
+  {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},  // n o
+  {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC},  // p q
+  {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},  // r s
+  {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C},  // t u
+  {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},  // v w
+  {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C},  // x y
+  {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},  // z {
+  {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00},  // | }
+  {0x02,0x01,0x02,0x04,0x02},                              // ~
+};
+
+//---column c (0..4) of character ch, blank for anything not in the table
+inline uint8_t font5x7Column(char ch, byte c)
+{
+  if (ch < FONT5X7_FIRST || ch > FONT5X7_LAST || c >= FONT5X7_WIDTH) return 0;
+  return pgm_read_byte(&font5x7[ch - FONT5X7_FIRST][c]);
+}
+
+#endif
@@ -0,0 +1,25 @@
+//---------------------------Hardware Abstraction----------------------------
+// The one place the sketch gets its platform from.  On the board this is
+// just the Arduino core and the libraries from platformio.ini.  In the
+// native build (pio run -e native) the same names - millis(), micros(),
+// digitalRead(), Serial, Wire and the avr-libc EEPROM calls - come from
+// the stand-ins in include/sim, which run on simulated time so the
+// whole state machine can be driven on Linux faster than real time.
+//
+// Bounce2 is not part of this layer: debouncing is done by EdgeCapture,
+// which the simulator feeds through the same path as the pin change ISR.
+//---------------------------------------------------------------------------
+
+#ifndef HAL_H
+#define HAL_H
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <Wire.h>
+#include <avr/eeprom.h>
+#else
+#include "sim/SimArduino.h"
+#include "sim/SimDevices.h"
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+//---------------------------Warm Start Journal------------------------------
+// Keeps what each yard needs to pick up where it left off after a reset -
+// the track last set up, where its turnouts were sent, rail power and
+// whether the lead was occupied - in the EEPROM, so a brown-out or a
+// watchdog reset resumes in milliseconds instead of starting cold.
+//
+// The journal is a ring of 8-byte records that is only ever appended to:
+//
+//   0..1   seq       increments per record
+//   2      yard
+//   3      track
+//   4      position  turnouts reverse, as RouteAligner has them
+//   5      known     turnouts whose position is known
+//   6      flags     JOURNAL_POWER, JOURNAL_OCCUPIED
+//   7      crc       CRC-8 of bytes 0..6
+//
+// A record is only written when a yard's entry differs from the last one
+// written for it, which happens on state transitions.  Writes never block:
+// service() writes one byte whenever the EEPROM has finished the last
+// (3.4ms a byte), so a record goes out over a few ticks.  The yard byte
+// is written 0xFF first and the yard last, so a reset part way through
+// leaves a slot begin() ignores whatever the crc happens to read - a
+// torn record checked by its crc alone would pass one time in 256 - and
+// the record it was overwriting was the oldest in the ring.  Before the
+// ring comes round to a yard's newest record, that record is written
+// again at the head, so every yard's newest record survives however
+// long it has been quiet.
+//
+// Appending round the ring spreads the writes evenly: each byte of the
+// ring is written once every slots records, the yard byte twice.
+//---------------------------------------------------------------------------
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Hal.h"
+
+struct JournalEntry
+{
+  byte track;
+  byte position, known;
+  byte flags;
+};
+enum { JOURNAL_POWER = 1, JOURNAL_OCCUPIED = 2 };
+
+class Journal
+{
+  public:
+    enum { RECORD = 8, MAX_YARDS = 4 };
+
+    //---scan the ring of bytes at base for each yard's newest record
+    void begin(uint16_t base, uint16_t bytes);
+
+    //---what begin() found for yard; false if it has none
+    bool recall(byte yard, JournalEntry &e) const;
+
+    //---the yard's entry as it is now; written if it has changed
+    void commit(byte yard, const JournalEntry &e);
+
+    //---write the next byte if the EEPROM is ready; call often
+    void service();
+
+    bool busy() const { return writePos < STEPS; }
+    unsigned long written() const { return records; }   //---since begin()
+
+  private:
+    bool read(uint16_t slot, byte *rec) const;   //---false if the crc is bad
+    uint16_t address(uint16_t slot) const { return base + slot * RECORD; }
+    void start(byte yard);
+
+    uint16_t      base, slots;
+    uint16_t      next, seq;           //---where and what the next record is
+    JournalEntry  saved[MAX_YARDS];    //---newest on the EEPROM
+    JournalEntry  wanted[MAX_YARDS];
+    uint16_t      savedSlot[MAX_YARDS];
+    bool          have[MAX_YARDS];     //---saved is valid
+    bool          dirty[MAX_YARDS];
+
+    enum { STEPS = RECORD + 1 };       //---bytes written per record
+    byte          buf[RECORD];         //---the record going out
+    byte          writePos;            //---step; STEPS when none is
+    unsigned long records;
+};
+
+extern Journal journal;
+
+#endif
@@ -0,0 +1,54 @@
+//---------------------------Track Selector Knob-----------------------------
+// Quadrature decoding of the rotary encoder from interrupt context, so a
+// quick spin of the knob is never missed while the display or the state
+// machine has the loop.
+//
+//   The ISR follows the two-bit Gray code through a transition table and
+//   counts one detent each time the encoder comes back to rest (both
+//   inputs high).  A missed transition in between still leaves enough
+//   quarter steps to tell the direction.  Detents turned in quick
+//   succession in the same direction count double or quadruple, so long
+//   track lists can be crossed in a flick and still stepped one by one.
+//
+//   take() hands the accumulated, accelerated detents to the encoder task
+//   and clears them, so the task only ever acts on the latest position.
+//
+// A2/A3 (PF2/PF3) have no pin change interrupt on the Mega 2560, so the
+// inputs are sampled by the Timer0 compare B interrupt, about every
+// 1.024ms - plenty for a hand turned detent knob.  The pin change
+// interrupts on A8-A15 belong to the yard sensors (EdgeCapture).
+//---------------------------------------------------------------------------
+
+#ifndef KNOBENCODER_H
+#define KNOBENCODER_H
+
+#include "Hal.h"
+
+class KnobEncoder
+{
+  public:
+    //---detents closer together than these count x2 and x4
+    enum { FAST_MS = 60, FASTER_MS = 25 };
+
+    void begin(byte pinA, byte pinB);
+    int  take();                     //---detents since the last call, +/-
+
+    //---interrupt context: the two input levels as of now
+    void sample(byte a, byte b, unsigned long ms);
+
+#if !defined(ARDUINO)
+    //---native build: turn the knob, one Gray code cycle per detent
+    void simTurn(int detents);
+#endif
+
+  private:
+    volatile int  turned;            //---accumulated detents, for take()
+    byte          lastAB;
+    int8_t        quarters;          //---quarter steps since the last rest
+    int8_t        lastDir;
+    unsigned long lastDetentMs;
+};
+
+extern KnobEncoder knob;
+
+#endif
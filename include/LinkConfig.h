@@ -0,0 +1,24 @@
+//---------------------------Link and Motor Settings-------------------------
+// What the panel (src/main.cpp) and the MotorMan driver (src/driver/) must
+// agree on: the speed of the serial link between them and the timing of
+// the turnout motors.  The driver throws the motors on this timing and
+// the panel works out from the same numbers how long rail power is off,
+// so both builds take them from here.
+//
+// A Tortoise takes about 3s end to end.  tortiPerStep start together and
+// the next tortiStaggerMs later, to spread the inrush; rail power comes
+// on tortiSettleMs after the last is home (RouteAligner.h).
+//---------------------------------------------------------------------------
+
+#ifndef LINKCONFIG_H
+#define LINKCONFIG_H
+
+#include "Hal.h"
+
+const unsigned long linkBaud       = 57600;
+const unsigned long tortiThrowMs   = 3000;
+const unsigned long tortiSettleMs  = 250;
+const byte          tortiPerStep   = 2;
+const unsigned long tortiStaggerMs = 250;
+
+#endif
@@ -0,0 +1,55 @@
+//---------------------------Mega 2560 Pin Map-------------------------------
+// The Arduino pin number to port and bit mapping of the Mega 2560, as
+// constexpr tables, so anything wired at compile time (SensorPair.h) can
+// find its port register and bit without the run-time PROGMEM lookups of
+// digitalPinToPort() / digitalPinToBitMask().  Port numbers are the core's
+// own (PA = 1 ... PL = 12), so portInputRegister() takes them as they are.
+//---------------------------------------------------------------------------
+
+#ifndef MEGAPINS_H
+#define MEGAPINS_H
+
+#include <stdint.h>
+
+enum MegaPort
+{
+  MEGA_NO_PORT = 0,
+  MEGA_PA = 1, MEGA_PB, MEGA_PC, MEGA_PD, MEGA_PE, MEGA_PF, MEGA_PG, MEGA_PH,
+  MEGA_PJ = 10, MEGA_PK, MEGA_PL,
+  MEGA_PORTS
+};
+
+enum { MEGA_PINS = 70, NO_PIN = 0xFF };   //---NO_PIN: nothing wired
+
+//---from the core's variants/mega/pins_arduino.h
+constexpr uint8_t megaPinPort[MEGA_PINS] = {
+  MEGA_PE, MEGA_PE, MEGA_PE, MEGA_PE, MEGA_PG, MEGA_PE, MEGA_PH, MEGA_PH,   //  0- 7
+  MEGA_PH, MEGA_PH, MEGA_PB, MEGA_PB, MEGA_PB, MEGA_PB, MEGA_PJ, MEGA_PJ,   //  8-15
+  MEGA_PH, MEGA_PH, MEGA_PD, MEGA_PD, MEGA_PD, MEGA_PD, MEGA_PA, MEGA_PA,   // 16-23
+  MEGA_PA, MEGA_PA, MEGA_PA, MEGA_PA, MEGA_PA, MEGA_PA, MEGA_PC, MEGA_PC,   // 24-31
+  MEGA_PC, MEGA_PC, MEGA_PC, MEGA_PC, MEGA_PC, MEGA_PC, MEGA_PD, MEGA_PG,   // 32-39
+  MEGA_PG, MEGA_PG, MEGA_PL, MEGA_PL, MEGA_PL, MEGA_PL, MEGA_PL, MEGA_PL,   // 40-47
+  MEGA_PL, MEGA_PL, MEGA_PB, MEGA_PB, MEGA_PB, MEGA_PB, MEGA_PF, MEGA_PF,   // 48-55
+  MEGA_PF, MEGA_PF, MEGA_PF, MEGA_PF, MEGA_PF, MEGA_PF, MEGA_PK, MEGA_PK,   // 56-63
+  MEGA_PK, MEGA_PK, MEGA_PK, MEGA_PK, MEGA_PK, MEGA_PK,                     // 64-69
+};
+constexpr uint8_t megaPinBit[MEGA_PINS] = {
+  0, 1, 4, 5, 5, 3, 3, 4,   5, 6, 4, 5, 6, 7, 1, 0,
+  1, 0, 3, 2, 1, 0, 0, 1,   2, 3, 4, 5, 6, 7, 7, 6,
+  5, 4, 3, 2, 1, 0, 7, 2,   1, 0, 7, 6, 5, 4, 3, 2,
+  1, 0, 3, 2, 1, 0, 0, 1,   2, 3, 4, 5, 6, 7, 0, 1,
+  2, 3, 4, 5, 6, 7,
+};
+
+//---MEGA_NO_PORT / 0 for a pin that does not exist (NO_PIN)
+constexpr uint8_t megaPort(uint8_t pin)
+{
+  return pin < MEGA_PINS ? megaPinPort[pin] : (uint8_t)MEGA_NO_PORT;
+}
+
+constexpr uint8_t megaBitMask(uint8_t pin)
+{
+  return pin < MEGA_PINS ? (uint8_t)(1 << megaPinBit[pin]) : 0;
+}
+
+#endif
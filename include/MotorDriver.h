@@ -0,0 +1,52 @@
+//---------------------------Motor Driver------------------------------------
+// The driver end of the MotorLink: takes ROUTE and POWER frames from the
+// panel, throws the turnouts and switches track power, and answers with
+// a STATUS for the yard each time its power changes or a route's motors
+// are home.  The motors and power outputs are hooks, so the same driver
+// runs on the Pro-Mini (src/driver/) and in the native simulator.
+//
+// A ROUTE cuts the yard's track power first, throws exactly the turnouts
+// the panel asks for through a RouteAligner (so no more than perStep
+// start together), and reports the route home - STATUS without
+// STATUS_MOVING, carrying the route's tag - once the last has had its
+// stroke.  Power asked for while the motors are moving comes on when they
+// are home.
+//---------------------------------------------------------------------------
+
+#ifndef MOTORDRIVER_H
+#define MOTORDRIVER_H
+
+#include "Hal.h"
+#include "MotorLink.h"
+#include "RouteAligner.h"
+
+class MotorDriver
+{
+  public:
+    enum { YARDS = RouteAligner::MAX_GROUPS };
+    typedef void (*PowerHook)(byte yard, bool on);
+
+    void begin(Stream &port, RouteAligner::ThrowHook motor, PowerHook power,
+               unsigned long throwMs, unsigned long settleMs, byte perStep,
+               unsigned long staggerMs, byte firstSeq);   //---MotorLink::begin()
+    void poll();
+
+    const MotorLink &link() const { return motorLink; }
+
+  private:
+    static void onFrame(byte type, const byte *payload, byte len);
+    void setPower(byte yard, bool on);
+    void report(byte yard);
+
+    MotorLink     motorLink;
+    RouteAligner  aligner;
+    PowerHook     powerHook;
+    byte          tag[YARDS];
+    bool          power[YARDS], powerWanted[YARDS], moving[YARDS];
+    bool          reportDue[YARDS];  //---STATUS waiting for room in the link queue
+    unsigned long homeMs[YARDS];     //---millis() the route's motors are home
+};
+
+extern MotorDriver motorDriver;
+
+#endif
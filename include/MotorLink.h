@@ -0,0 +1,118 @@
+//---------------------------Motor Driver Link-------------------------------
+// The serial link between the panel and the Pro-Mini that drives the
+// rr-CirKits MotorMan boards and the track power of each yard.  Both ends
+// run a MotorLink; everything the panel asks of the driver and everything
+// the driver reports back is a frame:
+//
+//   0      sync   0x7E
+//   1      type   LinkType; bit 7 on a sender's frames until its first is
+//                 acked, bit 6 when the ack byte is valid
+//   2      seq    the sender's frame number (0 in a bare ACK)
+//   3      ack    the last frame number taken in order from the other end
+//   4      len    payload bytes, up to MAX_PAYLOAD
+//   5..    payload
+//   last   crc    CRC-8 (polynomial 0x07) of bytes 1 to the end of payload
+//
+// Frames are delivered once and in order.  A sender has one frame on the
+// line at a time and sends it again every ackTimeoutMs until the other
+// end acks it; the rest wait in a queue of QUEUE frames.  Acks ride on
+// whatever frame goes back, or go in a bare ACK if nothing does.  A frame
+// that fails its CRC, or breaks off for more than a few ms, is dropped
+// and the receiver hunts for the next sync.  A frame numbered as the one
+// just taken is a resend whose ack was lost: it is acked again and not
+// delivered twice.  The first frame after begin() starts the numbering
+// and goes marked FIRST until it is acked.  A FIRST frame after unmarked
+// ones is an end that has started over; one after the FIRST frame just
+// taken is its resend unless the number differs, which it does as each
+// boot numbers from a count of boots kept in the EEPROM (bootSeq()).  So
+// a driver that resets is picked up again without either end being told.
+//
+// One ROUTE frame carries every turnout a route moves, so a route is set
+// up by one frame, one ack and one STATUS when its motors are home.
+//---------------------------------------------------------------------------
+
+#ifndef MOTORLINK_H
+#define MOTORLINK_H
+
+#include "Hal.h"
+
+enum LinkType
+{
+  LINK_ACK = 0,
+  LINK_ROUTE,        //--panel: RouteCommand
+  LINK_POWER,        //--panel: yard, 1 on / 0 off
+  LINK_STATUS,       //--driver: DriverStatus, when a route is home or power changes
+};
+
+struct RouteCommand
+{
+  byte yard;
+  byte tag;                        //---returned in the STATUS that ends it
+  byte moves;                      //---bit n: throw turnout n
+  byte reverse;                    //---bit n: to its diverging route
+};
+
+struct DriverStatus
+{
+  byte yard;
+  byte tag;                        //---of the last route taken
+  byte position;                   //---bit n: turnout n reverse
+  byte flags;                      //---STATUS_POWER, STATUS_MOVING
+};
+enum { STATUS_POWER = 1, STATUS_MOVING = 2 };
+
+class MotorLink
+{
+  public:
+    enum { SYNC = 0x7E, MAX_PAYLOAD = 8, QUEUE = 6, HEADER = 5 };
+    typedef void (*FrameHook)(byte type, const byte *payload, byte len);
+
+    void begin(Stream &port, FrameHook hook, unsigned long ackTimeoutMs, byte firstSeq);
+
+    //---a firstSeq one on from the last boot's: counts boots in the EEPROM
+    //   byte at address
+    static byte bootSeq(uint16_t address);
+
+    //---queue a frame; false if the queue is full
+    bool send(byte type, const void *payload, byte len);
+
+    //---take in what has arrived, ack it, send or resend; call often
+    void poll();
+
+    bool idle() const { return queued == 0; }
+    unsigned long framesSent() const { return sent; }
+    unsigned long resent() const     { return resends; }
+    unsigned long badFrames() const  { return bad; }
+
+    static byte crc8(byte crc, byte b);
+
+  private:
+    struct Frame { byte type, len; byte payload[MAX_PAYLOAD]; };
+
+    void receive(byte c);
+    void take();                       //---a whole frame with a good CRC
+    void transmit(byte type, byte seq, const byte *payload, byte len);
+
+    Stream       *port;
+    FrameHook     frameHook;
+    unsigned long ackMs;
+
+    Frame         queue[QUEUE];        //---queue[head] is the one on the line
+    byte          head, queued;
+    byte          txSeq;
+    bool          txStarted;           //---the other end has acked one of ours
+    bool          onLine;
+    unsigned long sentMs;
+
+    byte          rxLast;              //---last frame number taken
+    bool          rxFirst;             //---and it was marked FIRST
+    bool          rxStarted, ackDue;
+
+    byte          rx[HEADER + MAX_PAYLOAD + 1];
+    byte          rxLen;
+    unsigned long rxMs;                //---millis() of the last byte
+
+    unsigned long sent, resends, bad;
+};
+
+#endif
@@ -0,0 +1,115 @@
+//---------------------------Sensor Pair Bank--------------------------------
+// Busy, Direction and PassBy for every sensor pair at once.  It is the
+// same logic as PairState::update() (SensorPair.cpp), bit-sliced: each
+// field of the pair state is a Word with one bit per pair, and one
+// update() is a fixed run of AND/OR/XOR over those Words that advances
+// all of them together, with no branches and no per-pair loop.  A byte
+// holds the eight pairs of the four yards; a uint16_t would hold sixteen
+// for the same work.
+//
+//   levels   In and Out as last seen, active low        lvIn, lvOut
+//   busy     the history register, bit 0 In, bit 1 Out  bIn, bOut
+//   total    the running total, 3 bits                  t0, t1, t2
+//   six      the PassBy total is 6                      six
+//   direction, lastDirection  INBOUND, OUTBOUND bits    dIn, dOut, ldIn, ldOut
+//   passBy                                              pass
+//
+// The running total saturates at 7: once a pair has passed 6 it can only
+// get back to a PassBy by clearing first, so nothing above 6 matters.
+// (PairState's byte total would wrap after some 85 back and forth edges
+// without the pair ever clearing; that is the one place the two differ.)
+//
+// Levels that have not changed since the last update() leave a pair as
+// it was, so a pair may be advanced along with the others whether or not
+// it had an edge.  Each pair must see each of its edges in its own
+// update(), as with PairState.
+//---------------------------------------------------------------------------
+
+#ifndef PAIRBANK_H
+#define PAIRBANK_H
+
+#include "Hal.h"
+
+template <class Word>
+class PairBank
+{
+  public:
+    enum { LANES = sizeof(Word) * 8 };
+
+    void reset()
+    {
+      lvIn = lvOut = (Word)~0;
+      bIn = bOut = t0 = t1 = t2 = six = 0;
+      dIn = dOut = ldIn = ldOut = pass = 0;
+    }
+
+    //---bit n of each is pair n's In / Out level
+    void update(Word inLevels, Word outLevels)
+    {
+      //---In first, then Out, as PairState takes them
+      step(inLevels, lvIn, bIn);
+      step(outLevels, lvOut, bOut);
+
+      Word zero = ~(t0 | t1 | t2);
+      pass |= zero & six;
+      six  &= ~zero;
+
+      Word in  = t0 & ~t1 & ~t2 & bIn & ~bOut;     //--total 1, In alone
+      Word out = ~t0 & t1 & ~t2 & bOut & ~bIn;     //--total 2, Out alone
+      dIn   = (dIn & ~(out | zero)) | in;
+      dOut  = (dOut & ~(in | zero)) | out;
+      ldIn  = (ldIn & ~out) | in;
+      ldOut = (ldOut & ~in) | out;
+    }
+
+    //---a bit per pair
+    Word busyMask() const      { return bIn | bOut; }
+    Word passByMask() const    { return pass; }
+    Word inboundMask() const   { return dIn; }
+    Word outboundMask() const  { return dOut; }
+    Word lastInboundMask() const  { return ldIn; }
+    Word lastOutboundMask() const { return ldOut; }
+
+    //---one pair, as PairState has them
+    byte busy(byte p) const      { return lane(bIn, p) | lane(bOut, p) << 1; }
+    byte direction(byte p) const { return lane(dIn, p) | lane(dOut, p) << 1; }
+    byte lastDirection(byte p) const { return lane(ldIn, p) | lane(ldOut, p) << 1; }
+    byte passBy(byte p) const    { return lane(pass, p); }
+
+    void clearPassBy(Word pairs)        { pass &= ~pairs; }
+    void clearLastDirection(Word pairs) { ldIn &= ~pairs; ldOut &= ~pairs; }
+
+  private:
+    static byte lane(Word w, byte p) { return (w >> p) & 1; }
+
+    //---one sensor of every pair: where its level changed, set or clear
+    //   its busy bit, then add busy (In 1, Out 2) to the total, or clear
+    //   the total if the pair is now clear
+    void step(Word levels, Word &last, Word &busyBit)
+    {
+      Word changed = levels ^ last;
+      last    = levels;
+      busyBit = (busyBit & ~changed) | (~levels & changed);
+
+      Word c0  = t0 & bIn,  s0 = t0 ^ bIn;
+      Word h1  = t1 ^ bOut, s1 = h1 ^ c0;
+      Word c1  = (t1 & bOut) | (h1 & c0);
+      Word s2  = t2 ^ c1,   sat = t2 & c1;
+      s0 |= sat;
+      s1 |= sat;
+      s2 |= sat;
+
+      Word add  = changed & (bIn | bOut);
+      Word keep = ~changed;
+      t0  = (t0 & keep) | (s0 & add);
+      t1  = (t1 & keep) | (s1 & add);
+      t2  = (t2 & keep) | (s2 & add);
+      six = (six & ~add) | (add & ~s0 & s1 & s2);
+    }
+
+    Word lvIn, lvOut, bIn, bOut;
+    Word t0, t1, t2, six;
+    Word dIn, dOut, ldIn, ldOut, pass;
+};
+
+#endif
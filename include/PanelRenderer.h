@@ -0,0 +1,76 @@
+//---------------------------Panel Renderer----------------------------------
+// Drives the SSD1306 over I2C without a frame buffer.  The sketch names
+// each screen it can show with a 16 bit frame number and gives the
+// renderer a composer that draws any 8-row page of any frame into 128
+// bytes.  Only one page is ever in SRAM: service() composes the pages one
+// at a time into the page buffer and sends each straight out.
+//
+// The renderer remembers which frame each page of the panel is showing.
+// A page already showing the wanted frame costs nothing.  Any other page
+// is composed for both frames and only the columns from the first to the
+// last differing byte go out, so redrawing the same screen, like the
+// OCCUPIED warning, costs no bus traffic and a new track number a few
+// dozen bytes - as the 1KB shadow copy of the panel used to give, without
+// the shadow or the library's 1KB frame buffer.
+//
+// The transfer is sliced: show() only names the frame and returns.
+// service(), called from the display task, then sends at most a budget's
+// worth of CHUNK sized transfers per call, so a screen change is spread
+// across many ticks and the sensor and encoder tasks keep running in
+// between.  flushNow() is the blocking version.
+//---------------------------------------------------------------------------
+
+#ifndef PANELRENDERER_H
+#define PANELRENDERER_H
+
+#include "Hal.h"
+
+class PanelRenderer
+{
+  public:
+    enum { WIDTH = 128, PAGES = 8, CHUNK = 16 };   //--CHUNK data bytes/transfer
+
+    //---time one CHUNK transfer takes at 400kHz: (address + control +
+    //   CHUNK bytes) x 9 bits, plus start/stop and Wire overhead.
+    static const unsigned long CHUNK_US = 500;
+
+    //---draws page (0..7) of frame into buf, WIDTH bytes in SSD1306 page
+    //   order.  The same frame must always give the same page.
+    typedef void (*Composer)(uint16_t frame, byte page, uint8_t *buf);
+
+    PanelRenderer(Composer composer, byte i2cAddr);
+
+    bool begin();              //---panel init sequence; false if no answer
+    void command(uint8_t c);   //---one SSD1306 command, sent now
+    void show(uint16_t frame); //---frame is the one to go out
+    void service(unsigned long budgetUs);   //---send up to budgetUs worth
+    void flushNow();           //---send it all, blocking
+    void invalidate();         //---panel contents unknown, resend all
+    bool busy() const;
+    uint16_t frame() const { return wanted; }   //---the one wanted now
+
+    unsigned long bytesSent() const    { return dataBytes; }
+    unsigned long pagesSent() const    { return pages; }
+    unsigned long pagesSkipped() const { return skipped; }
+
+  private:
+    bool openNextSpan();       //---compose the next changed page, set window
+    void sendChunk();
+    void sendCommands(const uint8_t *cmds, byte n);
+
+    Composer         compose;
+    byte             addr;
+    uint16_t         wanted;
+    uint16_t         shown[PAGES];  //---frame each page of the panel holds
+    byte             known;         //---bit per page: shown[] is right
+
+    byte             nextPage;      //---where the look for a change starts
+    bool             spanOpen;      //---window is set, data still to send
+    byte             spanPage, spanCol, spanEnd;
+    uint16_t         spanFrame;     //---the frame page[] was composed for
+    uint8_t          page[WIDTH];
+
+    unsigned long    dataBytes, pages, skipped;
+};
+
+#endif
@@ -0,0 +1,86 @@
+//---------------------------Route Alignment---------------------------------
+// Sets the turnouts for a route by throwing only the ones that are not
+// already where the route needs them, instead of driving every motor and
+// waiting out a fixed delay.  A Route names the turnouts it goes over and
+// which way each must lie; the aligner remembers where it last put each
+// turnout of each group (a yard), so a route that shares its turnouts
+// with the last one moves nothing, and its neighbour usually one or two.
+// At power up no position is known and the first route throws all of its
+// turnouts.  With all set, align() throws every turnout the route uses,
+// for a motor driver that is told exactly what to move.
+//
+// align() works out the motors to move and how long until the last is
+// home, which is how long rail power must stay off:
+//
+//   nothing to move      settleMs
+//   n motors             throwMs + settleMs, plus staggerMs for each
+//                        further perStep motors
+//
+// perStep limits how many motors start together, to keep the inrush of
+// stall motors within the supply; the rest start staggerMs apart from
+// service().  perStep 0 starts them all at once.  The motors themselves
+// are driven by the throw hook given to begin().  Begun without one, the
+// aligner starts nothing and needs no service(): it only keeps where the
+// turnouts were sent and works out the moves and the time, for the panel,
+// whose motors the driver throws (MotorDriver.h).
+//---------------------------------------------------------------------------
+
+#ifndef ROUTEALIGNER_H
+#define ROUTEALIGNER_H
+
+#include "Hal.h"
+
+struct Route
+{
+  byte reverse;                    //---bit n: turnout n to its diverging route
+  byte uses;                       //---bit n: the route goes over turnout n
+};
+
+class RouteAligner
+{
+  public:
+    enum { MAX_GROUPS = 4, MAX_TURNOUTS = 8 };
+    typedef void (*ThrowHook)(byte group, byte turnout, bool reverse);
+
+    void begin(ThrowHook hook, unsigned long throwMs, unsigned long settleMs,
+               byte perStep, unsigned long staggerMs);
+
+    //---start moving group's turnouts for route; returns the ms until
+    //   the last of them is home
+    unsigned long align(byte group, const Route &route, bool all = false);
+
+    //---how long n motors take, as align() works it out
+    unsigned long throwTimeMs(byte n) const;
+
+    //---start the staggered throws that are due; call often
+    void service();
+
+    byte moves(byte group) const    { return groups[group].moves; }   //---by the last align()
+    byte moved(byte group) const;                                     //---how many
+    byte position(byte group) const { return groups[group].position; }
+    byte known(byte group) const    { return groups[group].known; }
+
+    //---where a group's turnouts were left before a reset (Journal.h)
+    void restore(byte group, byte position, byte known);
+
+  private:
+    void start(byte group);
+
+    struct Group
+    {
+      byte          position;      //---where each turnout was last sent
+      byte          known;         //---turnouts sent anywhere since power up
+      byte          pending;       //---still to be thrown
+      byte          moves;
+      unsigned long nextMs;        //---millis() the next of pending start
+    };
+
+    ThrowHook     throwHook;
+    unsigned long throwMs, settleMs, staggerMs;
+    byte          perStep;
+    Group         groups[MAX_GROUPS];
+};
+
+extern RouteAligner routeAligner;
+
+#endif
@@ -0,0 +1,80 @@
+//---------------------------Cooperative Scheduler---------------------------
+// A very small run-to-completion task scheduler.  Every piece of work the
+// panel does (reading sensors, the encoder, the display and the state
+// machine) is a Task: a short function that does one slice of work and
+// returns right away.  loop() calls Scheduler::tick() which starts each task
+// whose period has elapsed.
+//
+// Because no task ever blocks, the worst-case time from an input changing
+// to the state machine reacting is bounded by the sensor period plus the
+// state period plus the longest single task run.  The scheduler keeps the
+// worst lateness and run time of every task so that bound can be measured
+// on the layout instead of guessed; the sketch sends them as TLM_TASK
+// telemetry (Telemetry.h).
+//
+// For the shape rather than just the worst case, each task also keeps a
+// histogram of its run times and of its lateness, and the scheduler one
+// of the time each tick() - one pass of loop() - takes.  Periods that
+// went by without the task running at all are counted as missed.  These
+// run until clearProfile(), so they can cover hours of operation.
+//---------------------------------------------------------------------------
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Hal.h"
+
+//---Fixed power-of-two buckets of microseconds: bucket 0 is 0us, bucket
+//   b holds 2^(b-1) to 2^b - 1 and the last one everything above.  When
+//   a bucket is full every bucket is halved, which keeps the shape and so
+//   the percentiles however long it runs.
+struct Histogram
+{
+  enum { BUCKETS = 16 };
+  uint16_t      count[BUCKETS];
+  unsigned long minUs, maxUs;
+
+  void clear();
+  void add(unsigned long us);
+  static byte bucket(unsigned long us);
+  static unsigned long upperUs(byte b);         //---largest value in bucket b
+  unsigned long percentileUs(byte pct) const;   //---bucket edge, at most maxUs
+};
+
+struct Task
+{
+  const char    *name;
+  void         (*run)();
+  unsigned long  periodUs;       //---how often the task wants to run
+  unsigned long  lastRunUs;      //---start time of the previous run
+  unsigned long  maxLateUs;      //---worst delay past the due time
+  unsigned long  maxRunUs;       //---worst time spent in one run
+  unsigned long  runs;
+  Histogram      runHist;        //---since clearProfile()
+  Histogram      lateHist;
+  unsigned long  missed;         //---whole periods it did not run in
+};
+
+//--helper so task tables read cleanly: TASK("sensors", readAllSens, 1000)
+#define TASK(name, fn, periodUs) { name, fn, periodUs, 0, 0, 0, 0, {}, {}, 0 }
+
+class Scheduler
+{
+  public:
+    Scheduler(Task *taskList, byte taskCount);
+
+    void begin();                //---start every period from "now"
+    void tick();                 //---run every task that is due, once
+    void resetStats();
+    void clearProfile();         //---histograms and missed counts
+
+    const Histogram &loopHist() const { return passHist; }
+    const Task *find(const char *name) const;   //---0 if there is none
+
+  private:
+    Task     *tasks;
+    byte      count;
+    Histogram passHist;
+};
+
+#endif
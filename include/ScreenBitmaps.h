@@ -0,0 +1,255 @@
+//---------------------------Pre-rendered Screens----------------------------
+// GENERATED by tools/render_screens.py from the screen layouts in
+// src/main.cpp and include/Font5x7.h - do not edit, rerun the script.
+//
+// The ITEM_LABEL items of each screen, drawn as Adafruit_GFX would and
+// packed page by page (see unpackScreenPage() in ScreenLayout.h).  Entries
+// follow screenLayouts[]; 0 where a screen has nothing fixed to draw.
+//---------------------------------------------------------------------------
+
+#ifndef SCREENBITMAPS_H
+#define SCREENBITMAPS_H
+
+#include "Hal.h"
+
+//---splashItems, 667 bytes packed
+const uint8_t splashBitmap[] PROGMEM = {
+  0x98,0x00,0x01,0xFF,0xFF,0x85,0xC3,0x09,0x3C,0x3C,0x00,0x00,0x3C,0x3C,0xC3,0xC3,
+  0x3C,0x3C,0x85,0x00,0x01,0xFC,0xFC,0x85,0x03,0x01,0xFC,0xFC,0x8D,0x00,0x01,0xFF,
+  0xFF,0x85,0xC3,0x0D,0x3C,0x3C,0x00,0x00,0xF0,0xF0,0x0C,0x0C,0x03,0x03,0x0C,0x0C,
+  0xF0,0xF0,0x83,0x00,0x05,0x03,0x03,0xFF,0xFF,0x03,0x03,0x83,0x00,0x01,0xFF,0xFF,
+  0xA9,0x00,0x01,0x3F,0x3F,0x85,0x30,0x11,0x0F,0x0F,0x00,0x00,0x0F,0x0F,0x30,0x30,
+  0x33,0x33,0x0C,0x0C,0x33,0x33,0x00,0x00,0x0F,0x0F,0x85,0x30,0x01,0x0F,0x0F,0x8D,
+  0x00,0x0D,0x3F,0x3F,0x00,0x00,0x03,0x03,0x0C,0x0C,0x30,0x30,0x00,0x00,0x3F,0x3F,
+  0x85,0x03,0x01,0x3F,0x3F,0x83,0x00,0x05,0x30,0x30,0x3F,0x3F,0x30,0x30,0x83,0x00,
+  0x01,0x3F,0x3F,0x87,0x30,0x92,0x00,0x04,0x10,0xF0,0x10,0x00,0xF0,0x82,0x90,0x02,
+  0x10,0x00,0xF0,0x82,0x90,0x02,0x60,0x00,0xE0,0x82,0x10,0x02,0xE0,0x00,0xF0,0x82,
+  0x90,0x06,0x10,0x00,0xF0,0x40,0x80,0x00,0xF0,0x86,0x00,0x00,0xE0,0x82,0x10,0x08,
+  0x30,0x00,0xC0,0x20,0x10,0x20,0xC0,0x00,0xF0,0x82,0x90,0x02,0x60,0x00,0xF0,0x82,
+  0x90,0x0E,0x60,0x00,0x00,0x10,0xF0,0x10,0x00,0x00,0x30,0x10,0xF0,0x10,0x30,0x00,
+  0x60,0x82,0x90,0x02,0x20,0x00,0xF0,0x82,0x90,0x0E,0x10,0x00,0xF0,0x40,0x80,0x00,
+  0xF0,0x00,0x00,0x80,0x70,0x30,0x00,0x00,0x60,0x82,0x90,0x00,0x20,0x94,0x00,0x06,
+  0x02,0x04,0x04,0x03,0x00,0x00,0x07,0x83,0x04,0x07,0x00,0x07,0x00,0x01,0x02,0x04,
+  0x00,0x03,0x82,0x04,0x02,0x03,0x00,0x07,0x83,0x04,0x05,0x00,0x07,0x00,0x00,0x01,
+  0x07,0x86,0x00,0x06,0x03,0x04,0x04,0x05,0x07,0x00,0x07,0x82,0x01,0x11,0x07,0x00,
+  0x07,0x00,0x01,0x02,0x04,0x00,0x07,0x00,0x01,0x02,0x04,0x00,0x00,0x04,0x07,0x04,
+  0x83,0x00,0x00,0x07,0x82,0x00,0x00,0x02,0x82,0x04,0x02,0x03,0x00,0x07,0x83,0x04,
+  0x05,0x00,0x07,0x00,0x00,0x01,0x07,0x86,0x00,0x00,0x02,0x82,0x04,0x00,0x03,0x8C,
+  0x00,0x0D,0xFE,0xFE,0x18,0x18,0xE0,0xE0,0x18,0x18,0xFE,0xFE,0x00,0x00,0x80,0x80,
+  0x85,0x60,0x11,0x80,0x80,0x00,0x00,0xFE,0xFE,0x80,0x80,0x60,0x60,0x18,0x18,0x06,
+  0x06,0x00,0x00,0xFE,0xFE,0x85,0x86,0x11,0x06,0x06,0x00,0x00,0xFE,0xFE,0x60,0x60,
+  0x80,0x80,0x00,0x00,0xFE,0xFE,0x00,0x00,0x06,0x06,0x83,0x86,0x03,0xE6,0xE6,0x1E,
+  0x1E,0x83,0x00,0x05,0x06,0x06,0xFE,0xFE,0x06,0x06,0x83,0x00,0x01,0xFE,0xFE,0x85,
+  0x86,0x01,0x06,0x06,0xA1,0x00,0x0D,0x7F,0x7F,0x00,0x00,0x07,0x07,0x00,0x00,0x7F,
+  0x7F,0x00,0x00,0x1F,0x1F,0x85,0x60,0x11,0x19,0x19,0x00,0x00,0x7F,0x7F,0x01,0x01,
+  0x06,0x06,0x18,0x18,0x60,0x60,0x00,0x00,0x7F,0x7F,0x85,0x61,0x13,0x60,0x60,0x00,
+  0x00,0x7F,0x7F,0x00,0x00,0x01,0x01,0x06,0x06,0x7F,0x7F,0x00,0x00,0x78,0x78,0x67,
+  0x67,0x83,0x61,0x01,0x60,0x60,0x83,0x00,0x05,0x60,0x60,0x7F,0x7F,0x60,0x60,0x83,
+  0x00,0x01,0x7F,0x7F,0x85,0x61,0x01,0x60,0x60,0xBF,0x00,0x01,0xFC,0xFC,0x85,0x0C,
+  0x01,0xF0,0xF0,0x83,0x00,0x05,0x0C,0x0C,0xFC,0xFC,0x0C,0x0C,0x83,0x00,0x01,0xFC,
+  0xFC,0x85,0x00,0x01,0xFC,0xFC,0x83,0x00,0x05,0x0C,0x0C,0xFC,0xFC,0x0C,0x0C,0x83,
+  0x00,0x01,0xF0,0xF0,0x85,0x0C,0x01,0x30,0x30,0x83,0x00,0x05,0x0C,0x0C,0xFC,0xFC,
+  0x0C,0x0C,0x83,0x00,0x01,0xF0,0xF0,0x85,0x0C,0x07,0xF0,0xF0,0x00,0x00,0xFC,0xFC,
+  0xC0,0xC0,0x83,0x00,0x01,0xFC,0xFC,0xA1,0x00,0x01,0xFF,0xFF,0x85,0xC0,0x01,0x3F,
+  0x3F,0x83,0x00,0x05,0xC0,0xC0,0xFF,0xFF,0xC0,0xC0,0x83,0x00,0x09,0x0F,0x0F,0x30,
+  0x30,0xC0,0xC0,0x30,0x30,0x0F,0x0F,0x83,0x00,0x05,0xC0,0xC0,0xFF,0xFF,0xC0,0xC0,
+  0x83,0x00,0x01,0x30,0x30,0x85,0xC3,0x01,0x3C,0x3C,0x83,0x00,0x05,0xC0,0xC0,0xFF,
+  0xFF,0xC0,0xC0,0x83,0x00,0x01,0x3F,0x3F,0x85,0xC0,0x0D,0x3F,0x3F,0x00,0x00,0xFF,
+  0xFF,0x00,0x00,0x03,0x03,0x0C,0x0C,0xFF,0xFF,0x83,0x00,
+};
+
+//---housekeepItems, 617 bytes packed
+const uint8_t housekeepBitmap[] PROGMEM = {
+  0x01,0x3C,0x3C,0x85,0xC3,0x05,0x0C,0x0C,0x00,0x00,0xFF,0xFF,0x85,0xC3,0x05,0x03,
+  0x03,0x00,0x00,0xFF,0xFF,0x89,0x00,0x01,0xFF,0xFF,0x85,0xC3,0x05,0x03,0x03,0x00,
+  0x00,0xFC,0xFC,0x85,0x03,0x0D,0x0C,0x0C,0x00,0x00,0x0F,0x0F,0x03,0x03,0xFF,0xFF,
+  0x03,0x03,0x0F,0x0F,0x8D,0x00,0x0D,0xFF,0xFF,0x30,0x30,0xC0,0xC0,0x00,0x00,0xFF,
+  0xFF,0x00,0x00,0xFC,0xFC,0x85,0x03,0x0D,0xFC,0xFC,0x00,0x00,0xFF,0xFF,0x00,0x00,
+  0xC0,0xC0,0x00,0x00,0xFF,0xFF,0x89,0x00,0x01,0x0C,0x0C,0x85,0x30,0x05,0x0F,0x0F,
+  0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,
+  0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x0F,0x0F,0x85,0x30,0x01,0x0C,0x0C,0x85,0x00,
+  0x01,0x3F,0x3F,0x91,0x00,0x01,0x3F,0x3F,0x83,0x00,0x07,0x03,0x03,0x3F,0x3F,0x00,
+  0x00,0x0F,0x0F,0x85,0x30,0x0D,0x0F,0x0F,0x00,0x00,0x0F,0x0F,0x30,0x30,0x0F,0x0F,
+  0x30,0x30,0x0F,0x0F,0x89,0x00,0x0D,0xF0,0xF0,0x30,0x30,0xF0,0xF0,0x30,0x30,0xF0,
+  0xF0,0x00,0x00,0xF0,0xF0,0x85,0x30,0x01,0xC0,0xC0,0x83,0x00,0x05,0xC0,0xC0,0x30,
+  0x30,0xC0,0xC0,0x83,0x00,0x01,0xC0,0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xF0,
+  0xF0,0x83,0x00,0x03,0xC0,0xC0,0x30,0x30,0xC9,0x00,0x01,0xFF,0xFF,0x85,0x00,0x0D,
+  0xFF,0xFF,0x0C,0x0C,0x3C,0x3C,0xCC,0xCC,0x03,0x03,0x00,0x00,0xFF,0xFF,0x85,0x30,
+  0x05,0xFF,0xFF,0x00,0x00,0xFF,0xFF,0x85,0x00,0x0B,0xC0,0xC0,0x00,0x00,0xFF,0xFF,
+  0x0C,0x0C,0x33,0x33,0xC0,0xC0,0xC7,0x00,0x19,0x60,0x80,0x00,0x80,0x63,0x03,0x80,
+  0x40,0x20,0x40,0x80,0x00,0xE3,0x23,0x20,0x20,0xC0,0x00,0xE0,0x20,0x23,0x23,0xC0,
+  0x00,0x03,0x03,0x85,0x00,0x01,0x03,0x03,0x83,0x00,0x85,0x03,0x83,0x00,0x01,0x03,
+  0x03,0x85,0x00,0x01,0x03,0x03,0xC5,0x00,0x06,0xC0,0x40,0x4F,0x40,0x80,0x00,0xCF,
+  0x82,0x02,0x08,0xCF,0x00,0x8F,0x41,0x43,0x45,0x88,0x00,0xCF,0x82,0x08,0x00,0xC7,
+  0x86,0x00,0x00,0xC0,0x82,0x40,0x02,0x80,0x00,0xC0,0x82,0x00,0x0E,0xC0,0x00,0xC0,
+  0x40,0xC0,0x40,0xC0,0x00,0xC0,0x40,0xC0,0x40,0xC0,0x00,0x80,0x82,0x40,0x02,0x80,
+  0x00,0xC0,0x82,0x00,0x00,0xC0,0x86,0x00,0x06,0xC0,0x40,0xC0,0x40,0xC0,0x00,0x80,
+  0x82,0x40,0x00,0x80,0x86,0x00,0x00,0x80,0x82,0x40,0x02,0x80,0x00,0xC0,0x83,0x40,
+  0x01,0x00,0xC0,0x84,0x00,0x00,0xC0,0x83,0x40,0x01,0x00,0x80,0x82,0x40,0x06,0x80,
+  0x00,0xC0,0x40,0xC0,0x40,0xC0,0x82,0x00,0x00,0x1F,0x82,0x02,0x02,0x01,0x00,0x0F,
+  0x82,0x10,0x02,0x0F,0x00,0x09,0x82,0x12,0x02,0x0C,0x00,0x1F,0x82,0x02,0x00,0x1F,
+  0x86,0x00,0x00,0x1F,0x82,0x12,0x02,0x0D,0x00,0x0F,0x82,0x10,0x00,0x0F,0x82,0x00,
+  0x00,0x1F,0x84,0x00,0x00,0x1F,0x82,0x00,0x00,0x0F,0x82,0x10,0x06,0x0F,0x00,0x1F,
+  0x01,0x02,0x04,0x1F,0x88,0x00,0x00,0x1F,0x82,0x00,0x00,0x0F,0x82,0x10,0x00,0x0F,
+  0x86,0x00,0x00,0x09,0x82,0x12,0x02,0x0C,0x00,0x1F,0x82,0x12,0x02,0x10,0x00,0x1F,
+  0x83,0x10,0x01,0x00,0x1F,0x82,0x12,0x02,0x10,0x00,0x0F,0x82,0x10,0x00,0x08,0x82,
+  0x00,0x00,0x1F,0x84,0x00,0x12,0x03,0x01,0x7F,0x01,0x03,0x00,0x7F,0x09,0x19,0x29,
+  0x46,0x00,0x7C,0x12,0x11,0x12,0x7C,0x00,0x3E,0x82,0x41,0x06,0x22,0x00,0x7F,0x08,
+  0x14,0x22,0x41,0x86,0x00,0x00,0x7F,0x82,0x09,0x02,0x06,0x00,0x3E,0x82,0x41,0x08,
+  0x3E,0x00,0x3F,0x40,0x38,0x40,0x3F,0x00,0x7F,0x82,0x49,0x06,0x41,0x00,0x7F,0x09,
+  0x19,0x29,0x46,0x8C,0x00,0x84,0x08,0x01,0x00,0x7F,0x82,0x08,0x07,0x7F,0x00,0x7F,
+  0x08,0x14,0x22,0x41,0x00,0x84,0x08,0x9A,0x00,
+};
+
+//---selectItems, 623 bytes packed
+const uint8_t selectBitmap[] PROGMEM = {
+  0x01,0x3C,0x3C,0x85,0xC3,0x05,0x0C,0x0C,0x00,0x00,0xFF,0xFF,0x85,0xC3,0x05,0x03,
+  0x03,0x00,0x00,0xFF,0xFF,0x89,0x00,0x01,0xFF,0xFF,0x85,0xC3,0x05,0x03,0x03,0x00,
+  0x00,0xFC,0xFC,0x85,0x03,0x0D,0x0C,0x0C,0x00,0x00,0x0F,0x0F,0x03,0x03,0xFF,0xFF,
+  0x03,0x03,0x0F,0x0F,0x8D,0x00,0x0D,0xFF,0xFF,0x30,0x30,0xC0,0xC0,0x00,0x00,0xFF,
+  0xFF,0x00,0x00,0xFC,0xFC,0x85,0x03,0x0D,0xFC,0xFC,0x00,0x00,0xFF,0xFF,0x00,0x00,
+  0xC0,0xC0,0x00,0x00,0xFF,0xFF,0x89,0x00,0x01,0x0C,0x0C,0x85,0x30,0x05,0x0F,0x0F,
+  0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,
+  0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x0F,0x0F,0x85,0x30,0x01,0x0C,0x0C,0x85,0x00,
+  0x01,0x3F,0x3F,0x91,0x00,0x01,0x3F,0x3F,0x83,0x00,0x07,0x03,0x03,0x3F,0x3F,0x00,
+  0x00,0x0F,0x0F,0x85,0x30,0x0D,0x0F,0x0F,0x00,0x00,0x0F,0x0F,0x30,0x30,0x0F,0x0F,
+  0x30,0x30,0x0F,0x0F,0x89,0x00,0x0D,0xF0,0xF0,0x30,0x30,0xF0,0xF0,0x30,0x30,0xF0,
+  0xF0,0x00,0x00,0xF0,0xF0,0x85,0x30,0x01,0xC0,0xC0,0x83,0x00,0x05,0xC0,0xC0,0x30,
+  0x30,0xC0,0xC0,0x83,0x00,0x01,0xC0,0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xF0,
+  0xF0,0x83,0x00,0x03,0xC0,0xC0,0x30,0x30,0xC9,0x00,0x01,0xFF,0xFF,0x85,0x00,0x0D,
+  0xFF,0xFF,0x0C,0x0C,0x3C,0x3C,0xCC,0xCC,0x03,0x03,0x00,0x00,0xFF,0xFF,0x85,0x30,
+  0x05,0xFF,0xFF,0x00,0x00,0xFF,0xFF,0x85,0x00,0x0B,0xC0,0xC0,0x00,0x00,0xFF,0xFF,
+  0x0C,0x0C,0x33,0x33,0xC0,0xC0,0xC7,0x00,0x19,0x60,0x80,0x00,0x80,0x63,0x03,0x80,
+  0x40,0x20,0x40,0x80,0x00,0xE3,0x23,0x20,0x20,0xC0,0x00,0xE0,0x20,0x23,0x23,0xC0,
+  0x00,0x03,0x03,0x85,0x00,0x01,0x03,0x03,0x83,0x00,0x85,0x03,0x83,0x00,0x01,0x03,
+  0x03,0x85,0x00,0x01,0x03,0x03,0xC5,0x00,0x06,0xC0,0x40,0x4F,0x40,0x80,0x00,0xCF,
+  0x82,0x02,0x08,0xCF,0x00,0x8F,0x41,0x43,0x45,0x88,0x00,0xCF,0x82,0x08,0x00,0xC7,
+  0x86,0x00,0x00,0xC0,0x82,0x40,0x02,0x80,0x00,0xC0,0x82,0x00,0x0E,0xC0,0x00,0xC0,
+  0x40,0xC0,0x40,0xC0,0x00,0xC0,0x40,0xC0,0x40,0xC0,0x00,0x80,0x82,0x40,0x02,0x80,
+  0x00,0xC0,0x82,0x00,0x00,0xC0,0x86,0x00,0x06,0xC0,0x40,0xC0,0x40,0xC0,0x00,0x80,
+  0x82,0x40,0x00,0x80,0x86,0x00,0x00,0x80,0x82,0x40,0x02,0x80,0x00,0xC0,0x83,0x40,
+  0x01,0x00,0xC0,0x84,0x00,0x00,0xC0,0x83,0x40,0x01,0x00,0x80,0x82,0x40,0x06,0x80,
+  0x00,0xC0,0x40,0xC0,0x40,0xC0,0x82,0x00,0x00,0x1F,0x82,0x02,0x02,0x01,0x00,0x0F,
+  0x82,0x10,0x02,0x0F,0x00,0x09,0x82,0x12,0x02,0x0C,0x00,0x1F,0x82,0x02,0x00,0x1F,
+  0x86,0x00,0x00,0x1F,0x82,0x12,0x02,0x0D,0x00,0x0F,0x82,0x10,0x00,0x0F,0x82,0x00,
+  0x00,0x1F,0x84,0x00,0x00,0x1F,0x82,0x00,0x00,0x0F,0x82,0x10,0x06,0x0F,0x00,0x1F,
+  0x01,0x02,0x04,0x1F,0x88,0x00,0x00,0x1F,0x82,0x00,0x00,0x0F,0x82,0x10,0x00,0x0F,
+  0x86,0x00,0x00,0x09,0x82,0x12,0x02,0x0C,0x00,0x1F,0x82,0x12,0x02,0x10,0x00,0x1F,
+  0x83,0x10,0x01,0x00,0x1F,0x82,0x12,0x02,0x10,0x00,0x0F,0x82,0x10,0x00,0x08,0x82,
+  0x00,0x00,0x1F,0x84,0x00,0x12,0x03,0x01,0x7F,0x01,0x03,0x00,0x7F,0x09,0x19,0x29,
+  0x46,0x00,0x7C,0x12,0x11,0x12,0x7C,0x00,0x3E,0x82,0x41,0x06,0x22,0x00,0x7F,0x08,
+  0x14,0x22,0x41,0x86,0x00,0x00,0x7F,0x82,0x09,0x02,0x06,0x00,0x3E,0x82,0x41,0x08,
+  0x3E,0x00,0x3F,0x40,0x38,0x40,0x3F,0x00,0x7F,0x82,0x49,0x06,0x41,0x00,0x7F,0x09,
+  0x19,0x29,0x46,0x8C,0x00,0x84,0x08,0x01,0x00,0x3E,0x82,0x41,0x02,0x3E,0x00,0x7F,
+  0x82,0x09,0x02,0x01,0x00,0x7F,0x82,0x09,0x01,0x01,0x00,0x84,0x08,0x94,0x00,
+};
+
+//---aligningItems, 550 bytes packed
+const uint8_t aligningBitmap[] PROGMEM = {
+  0x0D,0xF0,0xF0,0x0C,0x0C,0x03,0x03,0x0C,0x0C,0xF0,0xF0,0x00,0x00,0xFF,0xFF,0x8B,
+  0x00,0x05,0x03,0x03,0xFF,0xFF,0x03,0x03,0x83,0x00,0x01,0xFC,0xFC,0x85,0x03,0x0D,
+  0x0F,0x0F,0x00,0x00,0xFF,0xFF,0x30,0x30,0xC0,0xC0,0x00,0x00,0xFF,0xFF,0x83,0x00,
+  0x05,0x03,0x03,0xFF,0xFF,0x03,0x03,0x83,0x00,0x0D,0xFF,0xFF,0x30,0x30,0xC0,0xC0,
+  0x00,0x00,0xFF,0xFF,0x00,0x00,0xFC,0xFC,0x85,0x03,0x01,0x0F,0x0F,0xA1,0x00,0x01,
+  0x3F,0x3F,0x85,0x03,0x05,0x3F,0x3F,0x00,0x00,0x3F,0x3F,0x87,0x30,0x83,0x00,0x05,
+  0x30,0x30,0x3F,0x3F,0x30,0x30,0x83,0x00,0x01,0x0F,0x0F,0x83,0x30,0x07,0x33,0x33,
+  0x3F,0x3F,0x00,0x00,0x3F,0x3F,0x83,0x00,0x03,0x03,0x03,0x3F,0x3F,0x83,0x00,0x05,
+  0x30,0x30,0x3F,0x3F,0x30,0x30,0x83,0x00,0x01,0x3F,0x3F,0x83,0x00,0x07,0x03,0x03,
+  0x3F,0x3F,0x00,0x00,0x0F,0x0F,0x83,0x30,0x03,0x33,0x33,0x3F,0x3F,0xA1,0x00,0x0D,
+  0xF0,0xF0,0x30,0x30,0xF0,0xF0,0x30,0x30,0xF0,0xF0,0x00,0x00,0xF0,0xF0,0x85,0x30,
+  0x01,0xC0,0xC0,0x83,0x00,0x05,0xC0,0xC0,0x30,0x30,0xC0,0xC0,0x83,0x00,0x01,0xC0,
+  0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xF0,0xF0,0x83,0x00,0x03,0xC0,0xC0,0x30,
+  0x30,0xC9,0x00,0x01,0xFF,0xFF,0x85,0x00,0x0D,0xFF,0xFF,0x0C,0x0C,0x3C,0x3C,0xCC,
+  0xCC,0x03,0x03,0x00,0x00,0xFF,0xFF,0x85,0x30,0x05,0xFF,0xFF,0x00,0x00,0xFF,0xFF,
+  0x85,0x00,0x0B,0xC0,0xC0,0x00,0x00,0xFF,0xFF,0x0C,0x0C,0x33,0x33,0xC0,0xC0,0xC7,
+  0x00,0x19,0x60,0x80,0x00,0x80,0x63,0x03,0x80,0x40,0x20,0x40,0x80,0x00,0xE3,0x23,
+  0x20,0x20,0xC0,0x00,0xE0,0x20,0x23,0x23,0xC0,0x00,0x03,0x03,0x85,0x00,0x01,0x03,
+  0x03,0x83,0x00,0x85,0x03,0x83,0x00,0x01,0x03,0x03,0x85,0x00,0x01,0x03,0x03,0xC5,
+  0x00,0x12,0xC0,0x00,0x0F,0x00,0xC0,0x00,0x0F,0x82,0x42,0x82,0x0F,0x00,0xCF,0x01,
+  0x03,0x05,0xC8,0x00,0xCF,0x82,0x48,0x00,0x47,0x87,0x00,0x02,0x80,0x40,0x80,0x87,
+  0x00,0x00,0xC0,0x82,0x00,0x08,0xC0,0x00,0x00,0x40,0xC0,0x40,0x00,0x00,0x80,0x82,
+  0x40,0x02,0x80,0x00,0xC0,0x83,0x40,0x86,0x00,0x00,0xC0,0x82,0x40,0x08,0x80,0x00,
+  0x00,0x80,0x40,0x80,0x00,0x00,0xC0,0x82,0x00,0x00,0xC0,0xA6,0x00,0x00,0x1F,0x82,
+  0x02,0x02,0x1F,0x00,0x1F,0x82,0x04,0x08,0x1F,0x00,0x07,0x08,0x10,0x08,0x07,0x00,
+  0x1F,0x82,0x12,0x00,0x10,0x86,0x00,0x00,0x1F,0x82,0x04,0x00,0x1F,0x86,0x00,0x0C,
+  0x1F,0x01,0x02,0x04,0x1F,0x00,0x00,0x10,0x1F,0x10,0x00,0x00,0x0F,0x82,0x10,0x02,
+  0x08,0x00,0x1F,0x82,0x12,0x00,0x10,0x86,0x00,0x00,0x1F,0x82,0x10,0x02,0x0F,0x00,
+  0x1F,0x82,0x04,0x05,0x1F,0x00,0x00,0x01,0x1E,0x01,0xA7,0x00,0x12,0x03,0x01,0x7F,
+  0x01,0x03,0x00,0x7F,0x09,0x19,0x29,0x46,0x00,0x7C,0x12,0x11,0x12,0x7C,0x00,0x3E,
+  0x82,0x41,0x06,0x22,0x00,0x7F,0x08,0x14,0x22,0x41,0x86,0x00,0x00,0x7F,0x82,0x09,
+  0x02,0x06,0x00,0x3E,0x82,0x41,0x08,0x3E,0x00,0x3F,0x40,0x38,0x40,0x3F,0x00,0x7F,
+  0x82,0x49,0x06,0x41,0x00,0x7F,0x09,0x19,0x29,0x46,0x8C,0x00,0x84,0x08,0x01,0x00,
+  0x3E,0x82,0x41,0x02,0x3E,0x00,0x7F,0x82,0x09,0x02,0x01,0x00,0x7F,0x82,0x09,0x01,
+  0x01,0x00,0x84,0x08,0x94,0x00,
+};
+
+//---proceedItems, 431 bytes packed
+const uint8_t proceedBitmap[] PROGMEM = {
+  0x93,0x00,0x01,0xFF,0xFF,0x85,0xC3,0x05,0x3C,0x3C,0x00,0x00,0xFF,0xFF,0x85,0xC3,
+  0x05,0x3C,0x3C,0x00,0x00,0xFC,0xFC,0x85,0x03,0x05,0xFC,0xFC,0x00,0x00,0xFC,0xFC,
+  0x85,0x03,0x05,0x0C,0x0C,0x00,0x00,0xFF,0xFF,0x85,0xC3,0x05,0x03,0x03,0x00,0x00,
+  0xFF,0xFF,0x85,0xC3,0x05,0x03,0x03,0x00,0x00,0xFF,0xFF,0x85,0x03,0x01,0xFC,0xFC,
+  0xAD,0x00,0x01,0x3F,0x3F,0x89,0x00,0x0D,0x3F,0x3F,0x00,0x00,0x03,0x03,0x0C,0x0C,
+  0x30,0x30,0x00,0x00,0x0F,0x0F,0x85,0x30,0x05,0x0F,0x0F,0x00,0x00,0x0F,0x0F,0x85,
+  0x30,0x05,0x0C,0x0C,0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x3F,0x3F,0x87,
+  0x30,0x03,0x00,0x00,0x3F,0x3F,0x85,0x30,0x01,0x0F,0x0F,0x99,0x00,0x09,0xF0,0xF0,
+  0x30,0x30,0xF0,0xF0,0x30,0x30,0xF0,0xF0,0x83,0x00,0x05,0x30,0x30,0xF0,0xF0,0x30,
+  0x30,0x83,0x00,0x0D,0xF0,0xF0,0xC0,0xC0,0x00,0x00,0xC0,0xC0,0xF0,0xF0,0x00,0x00,
+  0xF0,0xF0,0x87,0x30,0x03,0x00,0x00,0xF0,0xF0,0x85,0x30,0x01,0xC0,0xC0,0x8D,0x00,
+  0x01,0xC0,0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xF0,0xF0,0x85,0x00,0x01,0xF0,
+  0xF0,0xA5,0x00,0x01,0xFF,0xFF,0x89,0x00,0x01,0xFF,0xFF,0x85,0x00,0x0D,0xFF,0xFF,
+  0x00,0x00,0x3F,0x3F,0x00,0x00,0xFF,0xFF,0x00,0x00,0xFF,0xFF,0x85,0x0C,0x83,0x00,
+  0x09,0xFF,0xFF,0x0C,0x0C,0x3C,0x3C,0xCC,0xCC,0x03,0x03,0x8D,0x00,0x01,0xFF,0xFF,
+  0x85,0x00,0x0D,0xFF,0xFF,0x00,0x00,0xFF,0xFF,0x03,0x03,0x0C,0x0C,0x30,0x30,0xFF,
+  0xFF,0xA1,0x00,0x19,0x60,0x80,0x00,0x80,0x63,0x03,0x80,0x40,0x20,0x40,0x80,0x00,
+  0xE0,0x20,0x23,0x23,0xC3,0x03,0xE3,0x23,0x20,0x20,0xC0,0x00,0x03,0x03,0x85,0x00,
+  0x03,0x03,0x03,0x00,0x00,0x89,0x03,0x03,0x00,0x00,0x03,0x03,0x85,0x00,0x01,0x03,
+  0x03,0x8F,0x00,0x85,0x03,0x83,0x00,0x01,0x03,0x03,0x85,0x00,0x01,0x03,0x03,0xA3,
+  0x00,0x00,0x0F,0x82,0x00,0x00,0x0F,0x82,0x02,0x08,0x0F,0x00,0x0F,0x01,0x03,0x05,
+  0x08,0x00,0x0F,0x82,0x08,0x00,0x07,0xFF,0x00,0xE8,0x00,0x12,0x03,0x01,0x7F,0x01,
+  0x03,0x00,0x7F,0x09,0x19,0x29,0x46,0x00,0x7C,0x12,0x11,0x12,0x7C,0x00,0x3E,0x82,
+  0x41,0x06,0x22,0x00,0x7F,0x08,0x14,0x22,0x41,0x86,0x00,0x00,0x7F,0x82,0x09,0x02,
+  0x06,0x00,0x3E,0x82,0x41,0x08,0x3E,0x00,0x3F,0x40,0x38,0x40,0x3F,0x00,0x7F,0x82,
+  0x49,0x06,0x41,0x00,0x7F,0x09,0x19,0x29,0x46,0x8C,0x00,0x84,0x08,0x01,0x00,0x3E,
+  0x82,0x41,0x07,0x3E,0x00,0x7F,0x04,0x08,0x10,0x7F,0x00,0x84,0x08,0x9A,0x00,
+};
+
+//---occupiedItems, 456 bytes packed
+const uint8_t occupiedBitmap[] PROGMEM = {
+  0x19,0x0F,0x0F,0x30,0x30,0xC0,0xC0,0x30,0x30,0x0F,0x0F,0x00,0x00,0xF0,0xF0,0x0C,
+  0x0C,0x03,0x03,0x0C,0x0C,0xF0,0xF0,0x00,0x00,0xFF,0xFF,0x85,0xC3,0x05,0x3C,0x3C,
+  0x00,0x00,0xFF,0xFF,0x85,0x03,0x01,0xFC,0xFC,0x8D,0x00,0x01,0xFF,0xFF,0x89,0x00,
+  0x01,0xFF,0xFF,0x85,0xC3,0x11,0x03,0x03,0x00,0x00,0xF0,0xF0,0x0C,0x0C,0x03,0x03,
+  0x0C,0x0C,0xF0,0xF0,0x00,0x00,0xFF,0xFF,0x85,0x03,0x01,0xFC,0xFC,0x99,0x00,0x01,
+  0x3F,0x3F,0x85,0x00,0x01,0x3F,0x3F,0x85,0x03,0x11,0x3F,0x3F,0x00,0x00,0x3F,0x3F,
+  0x00,0x00,0x03,0x03,0x0C,0x0C,0x30,0x30,0x00,0x00,0x3F,0x3F,0x85,0x30,0x01,0x0F,
+  0x0F,0x8D,0x00,0x01,0x3F,0x3F,0x87,0x30,0x03,0x00,0x00,0x3F,0x3F,0x87,0x30,0x03,
+  0x00,0x00,0x3F,0x3F,0x85,0x03,0x05,0x3F,0x3F,0x00,0x00,0x3F,0x3F,0x85,0x30,0x01,
+  0x0F,0x0F,0x95,0x00,0x01,0xC0,0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xC0,0xC0,
+  0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,0xC0,0xC0,0x85,0x30,0x05,0xC0,0xC0,0x00,0x00,
+  0xF0,0xF0,0x85,0x00,0x05,0xF0,0xF0,0x00,0x00,0xF0,0xF0,0x85,0x30,0x01,0xC0,0xC0,
+  0x83,0x00,0x05,0x30,0x30,0xF0,0xF0,0x30,0x30,0x83,0x00,0x01,0xF0,0xF0,0x87,0x30,
+  0x03,0x00,0x00,0xF0,0xF0,0x85,0x30,0x01,0xC0,0xC0,0xA1,0x00,0x01,0xFF,0xFF,0x85,
+  0x00,0x05,0xFF,0xFF,0x00,0x00,0xFF,0xFF,0x85,0x00,0x05,0xC0,0xC0,0x00,0x00,0xFF,
+  0xFF,0x85,0x00,0x05,0xC0,0xC0,0x00,0x00,0xFF,0xFF,0x85,0x00,0x05,0xFF,0xFF,0x00,
+  0x00,0xFF,0xFF,0x85,0x0C,0x01,0x03,0x03,0x85,0x00,0x01,0xFF,0xFF,0x85,0x00,0x01,
+  0xFF,0xFF,0x85,0x0C,0x83,0x00,0x01,0xFF,0xFF,0x85,0x00,0x01,0xFF,0xFF,0xA3,0x00,
+  0x85,0x03,0x85,0x00,0x85,0x03,0x85,0x00,0x85,0x03,0x85,0x00,0x85,0x03,0x83,0x00,
+  0x01,0x03,0x03,0x8B,0x00,0x85,0x03,0x83,0x00,0x89,0x03,0x01,0x00,0x00,0x87,0x03,
+  0xB7,0x00,0x01,0xF0,0xF0,0x85,0x0C,0x11,0x30,0x30,0x00,0x00,0x3C,0x3C,0x0C,0x0C,
+  0xFC,0xFC,0x0C,0x0C,0x3C,0x3C,0x00,0x00,0xF0,0xF0,0x85,0x0C,0x05,0xF0,0xF0,0x00,
+  0x00,0xFC,0xFC,0x85,0x0C,0x01,0xF0,0xF0,0x85,0x00,0x01,0xFC,0xFC,0x8B,0x00,0x00,
+  0xC0,0x82,0x00,0x08,0xC0,0x00,0x00,0x80,0x40,0x80,0x00,0x00,0xC0,0x82,0x40,0x02,
+  0x80,0x00,0xC0,0x82,0x40,0x00,0x80,0xA6,0x00,0x01,0x30,0x30,0x85,0xC3,0x01,0x3C,
+  0x3C,0x85,0x00,0x01,0xFF,0xFF,0x85,0x00,0x01,0x3F,0x3F,0x85,0xC0,0x05,0x3F,0x3F,
+  0x00,0x00,0xFF,0xFF,0x85,0x03,0x87,0x00,0x01,0xCF,0xCF,0x8C,0x00,0x05,0x01,0x1E,
+  0x01,0x00,0x00,0x1F,0x82,0x04,0x08,0x1F,0x00,0x1F,0x02,0x06,0x0A,0x11,0x00,0x1F,
+  0x82,0x10,0x00,0x0F,0xFF,0x00,0x92,0x00,
+};
+
+//---3344 bytes of flash for 6 screens
+const uint8_t * const screenBitmaps[] PROGMEM = {
+  0, splashBitmap, housekeepBitmap, selectBitmap, aligningBitmap, proceedBitmap, occupiedBitmap, 0,
+};
+
+#endif
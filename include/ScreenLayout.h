@@ -0,0 +1,66 @@
+//---------------------------Screen Layouts----------------------------------
+// Each panel screen is a constant list of items - a label or a number at
+// a position and text size - kept in flash and drawn by drawLayoutPage().
+// Nothing is built on the heap and no label is ever copied into SRAM: the
+// labels are PROGMEM strings read straight from flash, and the numbers
+// on a screen (the track and the yard) are formatted into a small stack
+// buffer by formatNumber() instead of String or snprintf.
+//
+// A track that has a name instead of a number (the reverse loop, "RevL")
+// is drawn by the ITEM_NAMED item in place of the ITEM_NUMBER one; the
+// sketch says which applies when it draws the screen.
+//
+// There is no frame buffer: a screen is drawn one 8-row page at a time
+// into a 128 byte page buffer, as PanelRenderer asks for it.  The text is
+// drawn with the glyphs in Font5x7.h exactly as Adafruit_GFX would draw
+// it - same wrap, no background - clipped to the page.
+//
+// The labels never change, so tools/render_screens.py renders them ahead
+// of time into include/ScreenBitmaps.h.  unpackScreenPage() copies a page
+// of one of those into the page buffer and drawLayoutPage(..., true) then
+// only draws the track and yard fields on top.
+//---------------------------------------------------------------------------
+
+#ifndef SCREENLAYOUT_H
+#define SCREENLAYOUT_H
+
+#include "Hal.h"
+
+enum ItemKind
+{
+  ITEM_LABEL,        //---text, always drawn
+  ITEM_NUMBER,       //---the screen's value, 2 digits, if it has no name
+  ITEM_NAMED,        //---text, drawn instead of ITEM_NUMBER if it has one
+  ITEM_YARD,         //---the yard the screen is about, 1 digit
+};
+
+struct ScreenItem
+{
+  const char *text;  //---PROGMEM, unused for ITEM_NUMBER and ITEM_YARD
+  byte        x, y, size, kind;
+};
+
+struct ScreenLayout
+{
+  const ScreenItem *items;   //---PROGMEM
+  byte              count;
+};
+
+#define SCREEN_LAYOUT(items) { items, sizeof(items) / sizeof(items[0]) }
+
+//---right aligned in width characters, space padded; buf holds width + 1
+char *formatNumber(char *buf, unsigned int value, byte width);
+
+//---layout is in PROGMEM; draws the part of it that falls on page (0..7)
+//   into buf, 128 bytes in SSD1306 order, over what is there.  yard
+//   counts from 1 as on the fascia.  fieldsOnly skips the ITEM_LABELs,
+//   for a page that came from unpackScreenPage().
+void drawLayoutPage(uint8_t *buf, byte page, const ScreenLayout *layout,
+                    unsigned int value, bool named, byte yard,
+                    bool fieldsOnly = false);
+
+//---expand page (0..7) of a packed PROGMEM frame from ScreenBitmaps.h
+//   into buf, 128 bytes
+void unpackScreenPage(uint8_t *buf, const uint8_t *packed, byte page);
+
+#endif
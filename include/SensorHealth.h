@@ -0,0 +1,95 @@
+//---------------------------Sensor Health-----------------------------------
+// Watches every detector's debounced edges for the ways a detector fails
+// on the layout, and says which ones the yards should stop believing:
+//
+//   CHATTER       - CHATTER_EDGES or more edges in one second.  No train
+//                   does that; a detector with loose wiring or a flickering
+//                   emitter does, and every edge of it would be a phantom
+//                   Busy or PassBy.  Trusted again after QUIET_S seconds in
+//                   a row under a quarter of that rate.
+//   STUCK_BLOCKED - blocked for the stuck limit given to begin() while the
+//                   other detector of its pair has been clear and still
+//                   for as long: a dirty lens or a failed emitter, not a
+//                   train, which would have covered both by then.  Ends
+//                   with its next edge.
+//   STUCK_CLEAR   - its partner has seen STUCK_CLEAR_PASSES trains go by
+//                   while it never changed: a dead detector.  A train
+//                   that backs out over the partner counts too, so it
+//                   takes a run of them.  Ends with its next edge.
+//
+// masked() is true for CHATTER and STUCK_BLOCKED.  The sketch then runs
+// the pair on its other detector alone, as if the masked one read clear:
+// the yard can leave OCCUPIED, a train is still seen by the partner and
+// one that is not fully seen is released by the state timers.  A
+// STUCK_CLEAR detector already reads clear, so it is only reported.
+//
+// For telemetry each detector also has its edge count, its busiest
+// second and its longest blocked stretch; EdgeCapture has its glitches
+// and its debounce window.  Detectors are numbered as in EdgeCapture,
+// 2n is pair n's In and 2n + 1 its Out.
+//---------------------------------------------------------------------------
+
+#ifndef SENSORHEALTH_H
+#define SENSORHEALTH_H
+
+#include "Hal.h"
+#include "EdgeCapture.h"
+
+enum SensorCondition
+{
+  SENSOR_OK,
+  SENSOR_CHATTER,
+  SENSOR_STUCK_BLOCKED,
+  SENSOR_STUCK_CLEAR,
+};
+
+class SensorHealth
+{
+  public:
+    enum { MAX_SENSORS = EdgeCapture::MAX_SENSORS, CHATTER_EDGES = 16,
+           QUIET_S = 10, STUCK_CLEAR_PASSES = 10 };
+
+    void begin(byte sensorCount, unsigned long stuckMs);
+
+    //---every debounced edge, as it really was; true if the detector's
+    //   condition changed
+    bool edge(byte index, byte level, unsigned long ms);
+
+    //---once a second: judges each detector on the second just gone and
+    //   returns a bit per detector whose condition changed
+    uint16_t check(unsigned long ms);
+
+    byte condition(byte index) const { return sensors[index].condition; }
+    bool masked(byte index) const
+      { return condition(index) == SENSOR_CHATTER ||
+               condition(index) == SENSOR_STUCK_BLOCKED; }
+
+    uint16_t edges(byte index) const       { return sensors[index].edges; }
+    byte     busiestSecond(byte index) const { return sensors[index].busiest; }
+    uint16_t longestBlocked(byte index) const   //---0.1s
+      { return sensors[index].longestBlocked; }
+
+  private:
+    struct Sensor
+    {
+      unsigned long since;         //---ms of its last edge
+      uint16_t      edges;         //---since begin(), stops at 65535
+      uint16_t      longestBlocked;
+      byte          rate;          //---edges this second
+      byte          busiest;       //---most edges in one second
+      byte          quiet;         //---calm seconds while CHATTER
+      byte          partnerPasses; //---partner's trains since its last edge
+      byte          level : 1;
+      byte          condition : 2;
+    };
+
+    void noteBlocked(Sensor &s, unsigned long ms);
+
+    byte          count;
+    unsigned long stuck;
+    Sensor        sensors[MAX_SENSORS];
+};
+
+extern SensorHealth sensorHealth;
+
+#endif
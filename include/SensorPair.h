@@ -0,0 +1,105 @@
+//---------------------------Sensor Pairs------------------------------------
+// A detector pair - the In and Out sensor at a turnout - and the logic
+// that turns its two levels into Busy, Direction and PassBy (see the
+// sensor notes at the top of src/main.cpp).
+//
+//   PairState                  one pair's run-time state, 4 bytes.
+//                              update() takes the debounced In and Out
+//                              levels after each edge.  It is the plain
+//                              one-pair-at-a-time form of the logic; the
+//                              sketch runs all pairs at once through
+//                              PairBank (PairBank.h), and the simulator
+//                              checks the two against each other.
+//
+//   SensorPair<InPin, OutPin>  a pair's wiring, compile time only.
+//
+//   SensorBank<Pairs...>       every pair on the board.  Sensor 2n is
+//                              pair n's In, 2n + 1 its Out.  From the pin
+//                              numbers it works out, at compile time, which
+//                              bits of which port carry which sensor, and
+//                              port() hands that to EdgeCapture as one
+//                              CapturePort per port register.  The capture
+//                              ISRs then read each PINx once, however many
+//                              pairs share it, and more pairs are just more
+//                              template arguments.
+//---------------------------------------------------------------------------
+
+#ifndef SENSORPAIR_H
+#define SENSORPAIR_H
+
+#include "Hal.h"
+#include "MegaPins.h"
+#include "EdgeCapture.h"
+
+struct PairState
+{
+  byte sensTotal;               //---running total while busy
+  byte passByTotal;             //---6 once a train went all the way through
+  byte busy          : 2;       //---bit 0 In, bit 1 Out blocked
+  byte levels        : 2;       //---In, Out as last seen, active low
+  byte direction     : 2;       //---CLEAR, INBOUND, OUTBOUND while busy
+  byte lastDirection : 2;       //---kept after the pair clears
+  byte passBy        : 1;       //---set on PassBy, cleared by the sketch
+
+  void reset();                 //---clear, both sensors unblocked
+  void update(byte inLevel, byte outLevel);
+};
+
+template <byte InPin, byte OutPin>
+struct SensorPair
+{
+  static constexpr byte inPin  = InPin;
+  static constexpr byte outPin = OutPin;
+};
+
+template <class... Pairs> struct SensorBank;
+
+template <>
+struct SensorBank<>
+{
+  enum { PAIRS = 0, SENSORS = 0 };
+  static constexpr byte pin(byte) { return NO_PIN; }
+};
+
+template <class First, class... Rest>
+struct SensorBank<First, Rest...>
+{
+  typedef SensorBank<Rest...> Tail;
+  enum { PAIRS = 1 + Tail::PAIRS, SENSORS = 2 * PAIRS, NO_SENSOR = 0xFF };
+
+  static constexpr byte pin(byte s)
+  {
+    return s == 0 ? First::inPin : s == 1 ? First::outPin : Tail::pin(s - 2);
+  }
+
+  //---bits of port that carry sensors s and up
+  static constexpr byte mask(byte port, byte s = 0)
+  {
+    return s >= SENSORS ? 0 :
+           (byte)((megaPort(pin(s)) == port ? megaBitMask(pin(s)) : 0) | mask(port, s + 1));
+  }
+
+  static constexpr byte sensorAt(byte port, byte bit, byte s = 0)
+  {
+    return s >= SENSORS ? (byte)NO_SENSOR :
+           megaPort(pin(s)) == port && megaBitMask(pin(s)) == (1 << bit) ? s :
+           sensorAt(port, bit, s + 1);
+  }
+
+  static constexpr byte bits(byte m) { return m ? (m & 1) + bits(m >> 1) : 0; }
+
+  //---sensors wired to a pin, and how many of them are on port
+  static constexpr byte pinCount(byte s = 0)
+  {
+    return s >= SENSORS ? 0 : (pin(s) != NO_PIN) + pinCount(s + 1);
+  }
+  static constexpr byte pinsOn(byte port) { return bits(mask(port)); }
+
+  static constexpr CapturePort port(byte p)
+  {
+    return { p, mask(p), { sensorAt(p, 0), sensorAt(p, 1), sensorAt(p, 2), sensorAt(p, 3),
+                           sensorAt(p, 4), sensorAt(p, 5), sensorAt(p, 6), sensorAt(p, 7) } };
+  }
+};
+
+#endif
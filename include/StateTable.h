@@ -0,0 +1,87 @@
+//---------------------------Table Driven State Machine----------------------
+// The yard states and every way out of them are rows of a constant table
+//
+//   (state, event, guard, action, next)
+//
+// instead of code spread through the state functions.  Once per state
+// tick the sketch collects the events that are true right now into a bit
+// mask and calls dispatch().  The rows of the current state are tried in
+// table order; the first whose event is in the mask, and whose guard (also
+// an event bit) is in the mask too, runs its action and moves to next,
+// where that state's enter function runs.
+//
+// Rows must be grouped by state, in state order.  begin() notes where
+// each group starts, so a dispatch only looks at the rows of the current
+// state, and no state ever calls another - the stack is the same depth
+// whatever the trains do.  Tables live in flash; dump() prints them for
+// checking against the flow chart.
+//
+// One StateTable can drive several machines at once (one per yard).  Each
+// StateMachine keeps only its own state and timer, and hands its id to
+// the enter functions, actions and change hook so they know which yard
+// they are working on.  The table's timeout is where each state's timer
+// starts; setTimeout() moves it for the state the machine is in now, and
+// the next state starts from the table again.
+//---------------------------------------------------------------------------
+
+#ifndef STATETABLE_H
+#define STATETABLE_H
+
+#include "Hal.h"
+
+struct Transition
+{
+  byte state;
+  byte event;                //---bit number in the events mask
+  byte guard;                //---event bit that must also be set, or NO_GUARD
+  byte action;               //---index into the action list, 0 = none
+  byte next;
+};
+
+struct StateInfo
+{
+  void        (*enter)(byte id);   //---0 = nothing to do on entry
+  unsigned long timeoutMs;         //---timedOut() after this long, 0 = never
+};
+
+struct StateTable
+{
+  const Transition  *rows;         //---PROGMEM
+  byte               rowCount;
+  const StateInfo   *states;       //---PROGMEM
+  byte               stateCount;
+  void      (* const *actions)(byte id);   //---PROGMEM, [0] unused (no action)
+};
+
+class StateMachine
+{
+  public:
+    enum { MAX_STATES = 8, NO_GUARD = 0xFF };
+
+    void begin(const StateTable &table, byte id, byte initial,
+               void (*changed)(byte id, byte from, byte to));
+    bool dispatch(uint16_t events);   //---true if a row fired
+    byte state() const { return current; }
+    bool timedOut() const;            //---current state's timeout is up
+
+    unsigned long elapsedMs() const { return millis() - enteredMs; }
+    unsigned long timeout() const   { return timeoutMs; }
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }   //---from entry, 0 never
+
+    //--names are PROGMEM lists of NUL separated strings, in enum order
+    static void dump(Print &out, const StateTable &table, const char *stateNames,
+                     const char *eventNames, const char *actionNames);
+
+  private:
+    void enter(byte next);
+
+    const StateTable  *table;
+    byte               id;
+    byte               first[MAX_STATES + 1];   //---rows of s: first[s]..first[s+1]
+    byte               current;
+    unsigned long      enteredMs;
+    unsigned long      timeoutMs;
+    void             (*changed)(byte id, byte from, byte to);
+};
+
+#endif
@@ -0,0 +1,178 @@
+//---------------------------Event Telemetry---------------------------------
+// Replaces the text debug dump with small fixed-size binary records that
+// are only sent when something happens: a state change, a sensor edge, a
+// PassBy or a direction change.  tools/telemetry_decode.py turns the
+// stream back into a readable log.
+//
+// Record layout, 12 bytes, little endian:
+//
+//   0      sync   0xA5
+//   1      type   TelemetryType
+//   2      seq    increments per record sent; a gap means records were
+//                 lost on the wire.  Records the panel had no room to send
+//                 take no number and are counted in TLM_DROPPED instead.
+//   3      id     which state/yard/sensor/task the record is about
+//   4      val8
+//   5..6   val16
+//   7..10  us     micros() when the event happened
+//   11     check  XOR of bytes 1..10
+//
+// Records are never allowed to block: if the serial TX buffer has no room
+// the record is counted and dropped, and a TLM_DROPPED record with the
+// count goes out as soon as there is room again.
+//
+// Verbosity is chosen at compile time with TELEMETRY_LEVEL (see
+// platformio.ini build_flags); calls above the level compile to nothing.
+//
+//   0  off
+//   1  boot, faults, state changes, track selections, sensor health
+//   2  + PassBy and direction changes, knob selection
+//   3  + every debounced sensor edge and once a second task statistics,
+//        each yard's worst reaction time and sensor health figures
+//   4  + every raw, undebounced sensor edge, for recording traces with
+//        tools/trace_capture.py
+//
+// At any level above 0 a 'P' sent to the panel dumps the scheduler's
+// histograms (Scheduler.h) as TLM_HIST records, ending with one whose id
+// is HIST_END; tools/render_profile.py asks for them and draws them.
+//---------------------------------------------------------------------------
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "Hal.h"
+
+#ifndef TELEMETRY_LEVEL
+#define TELEMETRY_LEVEL 2
+#endif
+
+enum TelemetryType
+{
+  TLM_BOOT = 1,      //--val8: reset cause flags
+  TLM_FAULT,         //--id: fault code
+  TLM_STATE,         //--id: yard, val8: to state, val16: from state
+  TLM_TRACK,         //--id: yard, val8: track made active
+  TLM_SELECT,        //--id: yard, val8: track the knob points at
+  TLM_PASSBY,        //--id: sensor pair, val8: direction
+  TLM_DIRECTION,     //--id: sensor pair, val8: direction (0 = clear)
+  TLM_EDGE,          //--id: sensor index, val8: level (0 = blocked)
+  TLM_TASK,          //--id: task, val8: 0 max late / 1 max run, val16: us
+  TLM_COUNTER,       //--id: counter, val8:val16 low 24 bits of the value
+  TLM_DROPPED,       //--val16: records dropped since the last one sent
+  TLM_RAW_EDGE,      //--id: sensor index, val8: level, before debouncing
+  TLM_REACTION,      //--id: yard, val16: worst edge to state tick, us
+  TLM_TRAIN,         //--id: sensor pair, val8: 0 speed mm/s / 1 length mm
+  TLM_HOLD,          //--id: yard, val8: fitted to the train, val16: held, 10ms
+  TLM_RECOVERED,     //--id: yard, val8: holds, val16: s recovered
+  TLM_QUEUE,         //--id: yard, val8: track queued, val16: queued now
+  TLM_ALIGN,         //--id: yard, val8: turnouts moved, val16: power off ms
+  TLM_RESUME,        //--id: yard, val8: track, val16: JOURNAL_ flags, from the journal
+  TLM_READY,         //--id: BOOT_ milestone, val16: time from reset in 0.1ms
+  TLM_HIST,          //--id: task, HIST_LOOP_ID or HIST_END, val8: kind << 5 | slot,
+                     //  val16: bucket count, or us for HIST_MIN/MAX, or periods missed
+  TLM_HEALTH,        //--id: sensor index, val8: HEALTH_ item, val16: its value
+};
+
+//---LINK: a route the driver never confirmed; DRIVER: the driver's power or
+//   turnouts are not what the panel sent, as after a driver reset
+enum { FAULT_DISPLAY = 1, FAULT_LINK, FAULT_DRIVER };
+enum { BOOT_SENSORS, BOOT_CONTROL, BOOT_DISPLAY };   //---TLM_READY milestones
+
+//---TLM_HIST: slots 0-15 are the buckets of Histogram (Scheduler.h)
+enum { HIST_RUN, HIST_LATE, HIST_LOOP };                //---kind
+enum { HIST_MIN = 16, HIST_MAX, HIST_MISSED };          //---slot
+enum { HIST_LOOP_ID = 0xFF, HIST_END = 0xFE };          //---id
+
+//---TLM_HEALTH items: the SensorCondition (SensorHealth.h) whenever it
+//   changes, and at level 3 a sensor's figures in turn
+enum { HEALTH_CONDITION, HEALTH_EDGES, HEALTH_BUSIEST, HEALTH_BLOCKED,   //--BLOCKED: 0.1s
+       HEALTH_GLITCHES, HEALTH_WINDOW };                                //--WINDOW: us
+
+//---sensor pairs are numbered yard * 2 + PAIR_MAIN / PAIR_REV, sensors
+//   by their sensor number (Yard.h)
+enum { PAIR_MAIN = 0, PAIR_REV = 1 };
+
+class Telemetry
+{
+  public:
+    enum { RECORD_SIZE = 12, SYNC = 0xA5 };
+
+    void begin(HardwareSerial &serialPort);
+    void emit(byte type, byte id, byte val8, uint16_t val16, unsigned long us);
+    unsigned long dropped() const { return totalLost; }
+    bool room(byte records) const                 //---for bulk records
+      { return port && port->availableForWrite() >= records * RECORD_SIZE; }
+
+  private:
+    bool send(byte type, byte id, byte val8, uint16_t val16, unsigned long us);
+
+    HardwareSerial *port;
+    byte            seq;
+    uint16_t        lost;          //---dropped since the last TLM_DROPPED
+    unsigned long   totalLost;
+};
+
+extern Telemetry telemetry;
+
+//---Call sites use these; each compiles away below its level.
+inline void tlmEvent(byte level, byte type, byte id, byte val8,
+                     uint16_t val16, unsigned long us)
+{
+  if (TELEMETRY_LEVEL >= level) telemetry.emit(type, id, val8, val16, us);
+}
+
+inline void tlmState(byte yard, byte from, byte to)
+  { tlmEvent(1, TLM_STATE, yard, to, from, micros()); }
+inline void tlmTrack(byte yard, byte track)
+  { tlmEvent(1, TLM_TRACK, yard, track, 0, micros()); }
+inline void tlmFault(byte code)
+  { tlmEvent(1, TLM_FAULT, code, 0, 0, micros()); }
+inline void tlmReady(byte milestone, unsigned long us)
+  { tlmEvent(1, TLM_READY, milestone, 0, us / 100 > 0xFFFF ? 0xFFFF : us / 100, micros()); }
+inline void tlmSelect(byte yard, byte track)
+  { tlmEvent(2, TLM_SELECT, yard, track, 0, micros()); }
+inline void tlmPassBy(byte pair, byte direction, unsigned long us)
+  { tlmEvent(2, TLM_PASSBY, pair, direction, 0, us); }
+inline void tlmDirection(byte pair, byte direction, unsigned long us)
+  { tlmEvent(2, TLM_DIRECTION, pair, direction, 0, us); }
+inline void tlmEdge(byte sensor, byte level, unsigned long us)
+  { tlmEvent(3, TLM_EDGE, sensor, level, 0, us); }
+inline void tlmRawEdge(byte sensor, byte level, unsigned long us)
+  { tlmEvent(4, TLM_RAW_EDGE, sensor, level, 0, us); }
+inline void tlmTask(byte task, byte which, unsigned long valueUs)
+  { tlmEvent(3, TLM_TASK, task, which,
+             valueUs > 0xFFFF ? 0xFFFF : (uint16_t)valueUs, micros()); }
+inline void tlmReaction(byte yard, unsigned long worstUs)
+  { tlmEvent(3, TLM_REACTION, yard, 0,
+             worstUs > 0xFFFF ? 0xFFFF : (uint16_t)worstUs, micros()); }
+inline void tlmTrain(byte pair, byte which, uint16_t value, unsigned long us)
+  { tlmEvent(2, TLM_TRAIN, pair, which, value, us); }
+inline void tlmHold(byte yard, bool fitted, unsigned long heldMs)
+  { tlmEvent(2, TLM_HOLD, yard, fitted, heldMs / 10 > 0xFFFF ? 0xFFFF :
+             (uint16_t)(heldMs / 10), micros()); }
+inline void tlmQueue(byte yard, byte track, byte queued)
+  { tlmEvent(2, TLM_QUEUE, yard, track, queued, micros()); }
+inline void tlmAlign(byte yard, byte moved, unsigned long powerOffMs)
+  { tlmEvent(2, TLM_ALIGN, yard, moved, powerOffMs > 0xFFFF ? 0xFFFF :
+             (uint16_t)powerOffMs, micros()); }
+inline void tlmResume(byte yard, byte track, byte flags)
+  { tlmEvent(1, TLM_RESUME, yard, track, flags, micros()); }
+inline void tlmRecovered(byte yard, uint16_t holds, unsigned long recoveredMs)
+{
+  unsigned long s = recoveredMs / 1000;
+  tlmEvent(3, TLM_RECOVERED, yard, holds > 0xFF ? 0xFF : holds,
+           s > 0xFFFF ? 0xFFFF : (uint16_t)s, micros());
+}
+inline void tlmHist(byte id, byte kind, byte slot, unsigned long value)
+  { tlmEvent(1, TLM_HIST, id, kind << 5 | slot,
+             value > 0xFFFF ? 0xFFFF : (uint16_t)value, micros()); }
+inline void tlmHealth(byte sensor, byte condition)
+  { tlmEvent(1, TLM_HEALTH, sensor, HEALTH_CONDITION, condition, micros()); }
+inline void tlmHealthStat(byte sensor, byte item, unsigned long value)
+  { tlmEvent(3, TLM_HEALTH, sensor, item,
+             value > 0xFFFF ? 0xFFFF : (uint16_t)value, micros()); }
+inline void tlmCounter(byte counter, unsigned long value)
+  { tlmEvent(3, TLM_COUNTER, counter, (value >> 16) & 0xFF,
+             (uint16_t)value, micros()); }
+
+#endif
@@ -0,0 +1,56 @@
+//---------------------------Train Speed and Length--------------------------
+// Times each sensor's debounced edges so that, when a train has gone all
+// the way through a pair (a PassBy), its speed and length at that pair
+// can be worked out from the spacing of the pair's two detectors:
+//
+//   first sensor   blocked t1 ........................ clear t3
+//   second sensor           blocked t2 ........................ clear t4
+//
+//   lead = t2 - t1, tail = t4 - t3     both the time to cross the spacing
+//   speed  = 2 * spacing / (lead + tail)
+//   length = spacing * (t3 - t1 + t4 - t2) / (lead + tail)
+//
+// i.e. the time each detector was occupied, times the speed.  Taking the
+// nose and the tail together evens out a train that sped up or slowed
+// down while crossing.  The times are the first transition of each edge
+// (EdgeCapture), so debounce does not bias them.
+//---------------------------------------------------------------------------
+
+#ifndef TRAINGAUGE_H
+#define TRAINGAUGE_H
+
+#include "Hal.h"
+
+struct TrainMeasure
+{
+  byte          pair;              //---yard * 2 + PAIR_MAIN / PAIR_REV
+  byte          direction;         //---INBOUND 1, OUTBOUND 2
+  uint16_t      speedMmS;          //---model mm per second
+  uint16_t      lengthMm;
+  unsigned long us;                //---the edge that completed the PassBy
+};
+
+class TrainGauge
+{
+  public:
+    enum { MAX_PAIRS = 8 };
+
+    //---spacing: mm between the In and Out detectors of each pair, up
+    //   to 2m; 0 for a pair that is not there
+    void begin(const uint16_t *spacingMm, byte pairs);
+
+    //---every debounced edge, sensor 2n is pair n's In, 2n + 1 its Out
+    void edge(byte sensor, byte level, unsigned long us);
+
+    //---after a PassBy in direction: false if the times make no sense
+    bool measure(byte pair, byte direction, TrainMeasure &m) const;
+
+  private:
+    const uint16_t *spacing;
+    byte            pairCount;
+    unsigned long   blockedUs[MAX_PAIRS * 2], clearedUs[MAX_PAIRS * 2];
+};
+
+extern TrainGauge trainGauge;
+
+#endif
@@ -0,0 +1,127 @@
+//---------------------------Staging Yards-----------------------------------
+// One panel runs all four staging yards.  Everything one yard needs to
+// run on its own - its state machine, the track being chosen and the one
+// being held, rail power and the screen it last asked for - is a Yard,
+// and the sketch keeps one per yard in yards[].  The sensor pairs of all
+// the yards are advanced together in pairBank; yard y has pairs y * 2
+// (main) and y * 2 + 1 (rev), yardPairs(y) as a mask.
+// Every state tick advances each yard in turn, so a train in one yard
+// never holds up another: no yard waits on anything but its own inputs.
+//
+// The yards share the panel: one knob, one button, one bail out switch
+// and one display.  The knob steps through the tracks of every yard in
+// order, and the yard it points into is the focus - the one the button
+// and bail out switch act on and the one on the display.
+//
+// A press while the focus yard is busy with a route queues the track the
+// knob points at, up to ROUTE_QUEUE of them.  The yard takes the next one
+// straight from HOUSEKEEP into TRACK_SETUP as soon as its lead is clear,
+// instead of waiting in STAND_BY for the operator.
+//
+// Each track's route is a Route of yardRoutes[] (RouteAligner.h): the
+// turnouts of the yard's ladder it goes over and which way each lies.
+// TRACK_SETUP sends the driver (MotorLink.h) only those that differ from
+// where the last route left them, and keeps rail power off until the
+// driver reports them home.
+//
+// What a yard needs to pick up after a reset - the track last set up,
+// where its turnouts were sent, rail power and an occupied lead - goes to
+// the EEPROM journal (Journal.h) whenever it changes.  After a reset
+// each yard resumes from its entry: the turnouts are known to be where
+// they were sent, so the next route throws only what differs, and a yard
+// that was OCCUPIED starts OCCUPIED.
+//
+// The small fields of a Yard are packed into bitfields, as are the
+// per-sensor flags of EdgeCapture; src/main.cpp holds the SRAM budget
+// each part of the sketch's state has to fit.
+//
+// Sensors are numbered yard by yard: yard y's mainIn is
+// y * SENSORS_PER_YARD + MAIN_IN, and so on, and sensorPin() gives the pin
+// each is wired to.  A yard without a reverse loop has NO_PIN for its
+// revIn/revOut and its rev pair stays clear.
+//---------------------------------------------------------------------------
+
+#ifndef YARD_H
+#define YARD_H
+
+#include "Hal.h"
+#include "StateTable.h"
+#include "MegaPins.h"
+#include "PairBank.h"
+#include "TrainGauge.h"
+#include "RouteAligner.h"
+#include "Journal.h"
+#include "LinkConfig.h"
+
+enum { YARD_COUNT = 4 };
+enum { MAIN_IN, MAIN_OUT, REV_IN, REV_OUT, SENSORS_PER_YARD };
+enum { SENSOR_COUNT = YARD_COUNT * SENSORS_PER_YARD };
+enum { PAIR_COUNT = YARD_COUNT * 2 };
+enum { ROUTE_QUEUE = 3 };        //---Yard::queued has 2 bits
+enum { MAX_YARD_TRACKS = 6 };     //---7-12 on the knob
+
+struct YardInfo
+{
+  byte firstTrack, lastTrack;      //---the knob's range in this yard
+  bool revLoop;                    //---lastTrack is the reverse loop, "RevL"
+  uint16_t leadMm;                 //---main pair to firstTrack's clearance point
+  uint16_t ladderMm;               //---and on to each next track's
+};
+
+struct Yard
+{
+  StateMachine  machine;
+  byte          tracknumChoice : 4, tracknumActive : 4;   //---tracks 7-12
+  byte          tracknumLast : 4;
+  byte          screen : 4;        //---last screen it asked for
+  byte          railPower : 1;     //---ON 0, OFF 1
+  byte          routeSet : 1;      //---the driver has the route home
+  byte          inputPending : 1;  //---an edge its state tick has not seen
+  byte          holdFitted : 1;    //---TRACK_ACTIVE hold set from a measured train
+  byte          queued : 2;        //---entries of queue[]
+  byte          routePending : 1;  //---ROUTE not yet in the link queue
+  byte          powerPending : 1;  //---POWER not yet in the link queue
+  byte          routeTag;          //---of the last ROUTE sent to the driver
+  byte          routeMoves;        //---turnouts for the pending ROUTE to throw
+  unsigned long inputUs;           //---first transition of that edge
+  unsigned long worstReactUs;      //---edge to state tick, since last report
+  TrainMeasure  train;             //---last train through one of its pairs,
+                                   //   measured with the PassBy; pair 0xFF none
+  byte          queue[ROUTE_QUEUE];   //---tracks to set up next, oldest first
+  unsigned long lastEdgeMs;        //---millis() of its last sensor edge
+  uint16_t      holds;             //---TRACK_ACTIVE holds since boot
+  unsigned long recoveredMs;       //---trainTimerInterval less what they took,
+                                   //   for those that took less
+};
+
+extern Yard           yards[YARD_COUNT];
+extern const YardInfo yardInfo[YARD_COUNT];
+extern byte           focusYard;
+extern PairBank<byte> pairBank;
+extern const uint16_t pairSpacingMm[PAIR_COUNT];
+
+byte sensorPin(byte sensor);      //---NO_PIN when not wired
+
+inline byte yardPairs(byte y) { return 3 << (y * 2); }
+
+//---turnouts for track's route, false if the yard has no such track
+//   (src/main.cpp); the motor timing is in LinkConfig.h
+bool trackRoute(byte y, byte track, Route &r);
+
+//---the yard as the journal keeps it (src/main.cpp)
+JournalEntry yardEntry(byte y);
+extern const uint16_t journalBase, journalBytes;
+
+//---how long a sensor may stay blocked with its partner clear before it
+//   is taken for stuck (SensorHealth.h, src/main.cpp)
+extern const unsigned long sensStuckMs;
+
+//---micros() at the first sensor sample, state tick and full screen;
+//   0 until then (src/main.cpp)
+extern unsigned long bootSensorsUs, bootControlUs, bootDisplayUs;
+
+//---TRACK_ACTIVE hold for an arriving train (src/main.cpp)
+unsigned long trackDistanceMm(byte y, byte track);
+unsigned long clearanceMs(byte y, byte track, uint16_t speedMmS);
+
+#endif
@@ -0,0 +1,164 @@
+//---------------------------Simulated Arduino Core--------------------------
+// Just enough of the Arduino core for the sketch to build and run on the
+// host.  Time only moves when the simulator advances it (or the sketch
+// calls delay()), and pin levels are set by the simulator, so every run is
+// deterministic and as fast as the host can go.
+//---------------------------------------------------------------------------
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <deque>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+//---analog pins on the Mega 2560
+#define A0 54
+#define A1 55
+#define A2 56
+#define A3 57
+#define A8 62
+#define A9 63
+#define A10 64
+#define A11 65
+#define A12 66
+#define A13 67
+
+#define bitRead(value, b)  (((value) >> (b)) & 0x01)
+#define bitSet(value, b)   ((value) |= (1UL << (b)))
+#define bitClear(value, b) ((value) &= ~(1UL << (b)))
+#define _BV(b)             (1 << (b))
+
+//---flash is just memory on the host
+#define PROGMEM
+#define PSTR(s)              (s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_ptr(addr)   (*(const void * const *)(addr))
+#define memcpy_P             memcpy
+#define strlen_P             strlen
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+#define noInterrupts()
+#define interrupts()
+
+//---time and pins
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+//---simulator side
+enum { SIM_PINS = 70 };
+void     simAdvanceUs(unsigned long us);   //---move simulated time forward
+uint64_t simNowUs();
+void     simSetPin(uint8_t pin, uint8_t level);  //---drive an input pin
+uint8_t  simPinOutput(uint8_t pin);              //---what the sketch wrote
+void     simOnPinChange(void (*isr)());          //---stands in for PCINTs
+uint8_t  simReadPort(uint8_t port);              //---PINx, MegaPins.h numbering
+void     simReset();
+
+//---------------------------String / Print----------------------------------
+class String
+{
+  public:
+    String(const char *s = "") : str(s ? s : "") {}
+    String(const __FlashStringHelper *s) : str(reinterpret_cast<const char *>(s)) {}
+    String(int n) : str(std::to_string(n)) {}
+    const char *c_str() const { return str.c_str(); }
+    unsigned int length() const { return str.length(); }
+
+  private:
+    std::string str;
+};
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t n)
+    {
+      for (size_t i = 0; i < n; i++) write(buf[i]);
+      return n;
+    }
+    virtual int availableForWrite() { return 0; }
+
+    size_t print(const char *s)                { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(const String &s)              { return print(s.c_str()); }
+    size_t print(char c)                       { return write((uint8_t)c); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(int n, int base = DEC)          { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(unsigned char n, int base = DEC){ return print((unsigned long)n, base); }
+
+    template <typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+    size_t println() { return print("\r\n"); }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+//---Serial on the host: bytes go to a hook (the simulator decodes the
+//   telemetry) and the TX buffer never fills.  Two ports can instead be
+//   wired to each other, as the panel and the motor driver are: each byte
+//   reaches the other end usPerByte after the last, as at the line's
+//   baud rate, with the chance of a bit being flipped on the way set by
+//   simNoise().
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c);
+    using Print::write;
+    int availableForWrite() { return 4096; }
+    int available();
+    int read();
+    void flush() {}
+    void onWrite(void (*hook)(uint8_t)) { writeHook = hook; }
+
+    void simConnect(HardwareSerial &other, unsigned long usPerByte);
+    void simNoise(double perByte) { noise = perByte; }
+    void simReceive(uint8_t c) { rx.push_back({simNowUs(), c}); }   //---from the host
+
+  private:
+    struct Byte { uint64_t us; uint8_t c; };
+    void (*writeHook)(uint8_t) = 0;
+    HardwareSerial *peer = 0;
+    unsigned long   byteUs = 0;
+    uint64_t        lineFreeUs = 0;   //---when the last byte written is through
+    double          noise = 0;
+    std::deque<Byte> rx;
+};
+
+extern HardwareSerial Serial, Serial1;
+
+#endif
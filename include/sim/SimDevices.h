@@ -0,0 +1,85 @@
+//---------------------------Simulated Devices-------------------------------
+// Host stand-ins for the libraries in platformio.ini, same names and the
+// calls the sketch uses:
+//
+//   TwoWire           - counts bytes and transactions, and advances the
+//                       simulated clock by the time the transfer would
+//                       take on a real bus, so blocking I2C shows up in
+//                       the task timings.  Counts transfers tried before
+//                       begin(), which the Mega's Wire would hang on.
+//   SimOled           - the SSD1306 panel itself, on the simulated bus:
+//                       it decodes the command and data transfers into
+//                       its own display RAM, so a simulation can check
+//                       what is actually on the screen.
+//   avr/eeprom.h      - the Mega's 4KB EEPROM; a byte write keeps it busy
+//                       for 3.4ms of simulated time, as the real one is,
+//                       and every write is counted per byte for wear.
+//---------------------------------------------------------------------------
+
+#ifndef SIM_DEVICES_H
+#define SIM_DEVICES_H
+
+#include "sim/SimArduino.h"
+
+//---------------------------TwoWire-----------------------------------------
+class TwoWire : public Print
+{
+  public:
+    void begin() { begun = true; }
+    void setClock(unsigned long hz) { clockHz = hz; }
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool stop = true);
+    size_t write(uint8_t c);
+    using Print::write;
+
+    //---simulator side
+    unsigned long bytes = 0, transactions = 0;
+    bool simNack = false;            //---nothing on the bus answers
+    bool begun = false;
+    unsigned long beforeBegin = 0;   //---transfers tried before begin()
+    void (*onTransmit)(uint8_t address, const uint8_t *data, size_t n) = 0;
+
+  private:
+    unsigned long clockHz = 100000;
+    uint8_t       addr = 0;
+    uint8_t       buf[32];
+    size_t        len = 0;
+};
+
+extern TwoWire Wire;
+
+//---------------------------SimOled----------------------------------------
+class SimOled
+{
+  public:
+    SimOled(TwoWire &bus, uint8_t address);
+
+    bool     on = false;             //---display on/off command state
+    uint8_t  ram[128 * 64 / 8];      //---what the panel is showing
+
+  private:
+    void receive(const uint8_t *data, size_t n);
+    static void transmit(uint8_t address, const uint8_t *data, size_t n);
+
+    uint8_t   i2caddr;
+
+    //---the panel's own addressing state
+    uint8_t   colStart = 0, colEnd = 127, pageStart = 0, pageEnd = 7;
+    uint8_t   col = 0, page = 0;
+    uint8_t   cmdArgs = 0, cmdPending = 0, cmdBuf[3];
+};
+
+extern SimOled simOled;
+
+//---------------------------EEPROM------------------------------------------
+enum { SIM_EEPROM_SIZE = 4096 };
+uint8_t eeprom_read_byte(const uint8_t *addr);
+void    eeprom_write_byte(uint8_t *addr, uint8_t value);   //---waits if busy
+bool    eeprom_is_ready();
+
+//---simulator side; the contents outlive simReset(), as on the board
+extern uint8_t  simEeprom[SIM_EEPROM_SIZE];
+extern uint32_t simEepromWrites[SIM_EEPROM_SIZE];
+void simEepromErase();               //---back to 0xFF, wear counts cleared
+
+#endif
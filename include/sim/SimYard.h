@@ -0,0 +1,158 @@
+//---------------------------Simulated Yard----------------------------------
+// Drives the sketch the way the layout would: an operator who turns the
+// knob and presses the button, trains that pass the sensor pairs (with
+// contact chatter on every edge), and the bail out switch.  It watches
+// the state changes in the sketch's own telemetry and checks that each
+// movement produced the expected sequence of states in time.
+//
+// All four yards run movements at the same time, each on its own clock,
+// so trains in one yard overlap whatever the others are doing.  The
+// operator is shared like the real panel: a movement that needs the knob
+// waits for it, steps it into its yard and track one detent at a time,
+// presses the button and hands the knob on once the button is back up.
+// BAIL_OUT keeps the knob until the switch has been used, as the switch
+// acts on the yard the knob points into.
+//
+// Each train that goes through a pair has a known speed and length, from
+// the pair's detector spacing (pairSpacingMm[]) and the edge times, and
+// the speed and length the sketch reports for it are checked against them.
+//
+// The motor driver (MotorDriver.h) runs alongside the sketch, joined to
+// its Serial1 by a simulated serial line, and its motor and power
+// outputs are followed per yard.  Whenever the sketch leaves TRACK_SETUP
+// the yard's turnouts must lie as the route to the reported track needs
+// and the last must have had its full stroke.  No more than tortiPerStep
+// motors may start together, none may move with the yard's rail power on,
+// and power may not come on while one is moving.
+//
+// Movements:
+//   DEPART    - select a track, train leaves outbound through a pair,
+//               the yard must release as soon as it has passed
+//   ARRIVE    - select a track, train arrives inbound, the yard must hold
+//               until the train is in the track at its actual speed, and
+//               release within the gauge tolerance of the hold fitted to it
+//   LEAD_BUSY - train pulls onto the lead in STAND_BY, stalls and backs
+//               off again: OCCUPIED, then back to STAND_BY
+//   BAIL_OUT  - select a track, then the bail out switch ends TRACK_ACTIVE
+//   PIPELINE  - select a track, then queue a second while the first is
+//               set up; a train departs from each, and the second route
+//               must start the moment the first releases
+//---------------------------------------------------------------------------
+
+#ifndef SIM_YARD_H
+#define SIM_YARD_H
+
+#include "Hal.h"
+#include "Telemetry.h"
+#include "Yard.h"
+#include "sim/Trace.h"
+#include <vector>
+
+//---keep in step with src/main.cpp; the sensors are sensorPin()
+namespace SimPins
+{
+  const uint8_t knobSwitch = 2, bailOut = 8;
+}
+
+namespace SimStates
+{
+  enum { HOUSEKEEP, STAND_BY, TRACK_SETUP, TRACK_ACTIVE, OCCUPIED, NONE = 0xFF };
+  const char *name(uint8_t s);
+}
+
+class SimYard
+{
+  public:
+    enum Movement { DEPART, ARRIVE, LEAD_BUSY, BAIL_OUT, PIPELINE, MOVEMENT_TYPES };
+    static constexpr double TRAIN_TIMER_S = 15;   //---the sketch's fixed hold
+    static constexpr double TORTI_TIMER_S = 4;    //---its old fixed alignment wait
+
+    struct Stats
+    {
+      unsigned long movements = 0, failures = 0;
+      unsigned long byType[MOVEMENT_TYPES] = {0};
+      unsigned long byYard[YARD_COUNT] = {0};
+      unsigned long worstReleaseUs = 0;    //---last edge to HOUSEKEEP (DEPART)
+      unsigned long worstOccupiedUs = 0;   //---first edge to OCCUPIED
+      unsigned long reactUs[YARD_COUNT] = {0};   //---worst, as the sketch reports it
+      unsigned      mostBusy = 0;          //---yards with a movement at once
+      unsigned long trains = 0;            //---speed and length reported
+      double        worstSpeedErr = 0, worstLengthErr = 0;   //---percent
+      unsigned long holds = 0, fittedHolds = 0;
+      double        recoveredS = 0;        //---holds under TRAIN_TIMER_S, as the sketch counts it
+      unsigned long routes = 0, thrown = 0, unmoved = 0;   //---routes set up
+      double        setupS = 0;            //---TRACK_SETUP, all routes
+      unsigned long flagged[4] = {0};      //---sensor conditions reported (SensorHealth.h)
+    };
+
+    SimYard(uint32_t seed, unsigned long stepUs);
+
+    void fireDue();                    //---apply actions that are due now
+    uint64_t nextActionUs() const;     //---UINT64_MAX when nothing queued
+    void observe();                    //---react to the states seen so far
+    void onTelemetry(uint8_t c);       //---feed from Serial
+    void onMotor(uint8_t yard, uint8_t turnout, bool reverse);   //---driver outputs
+    void onPower(uint8_t yard, bool on);
+    void driverReset();                //---its outputs all drop at once
+    bool railPower(uint8_t yard) const { return lanes[yard].power; }
+    uint8_t points(uint8_t yard) const { return lanes[yard].points; }
+    void setVerbose(bool v) { verbose = v; }
+    void setTrace(TraceWriter *t) { trace = t; }   //---record sensor edges
+
+    const Stats &stats() const { return st; }
+
+  private:
+    struct Action { uint64_t us; uint8_t kind, pin, level, yard; };
+    enum { PIN, MARK };
+    enum { NO_OPERATOR = 0xFF };
+
+    struct Seen { uint8_t state; uint64_t us; };
+
+    struct Lane                        //---one yard's side of the simulation
+    {
+      uint8_t   current = SimStates::NONE;
+      uint64_t  currentSince = 0, idleUs = 0;
+      std::vector<Seen> seen;          //---states entered this movement
+      bool      active = false, trainSent = false;
+      Movement  movement = DEPART;     //---running, or next when idle
+      uint8_t   track = 0, trackReported = 0;
+      uint8_t   firstTrack = 0, firstReported = 0;   //---PIPELINE's first route
+      bool      queued = false, secondLeg = false;
+      uint64_t  movementStart = 0, firstEdgeUs = 0, lastEdgeUs = 0;
+      unsigned  pending = 0;           //---its actions still queued
+      double    speedMmS = 0, lengthMm = 0;   //---of the train sent
+      uint8_t   points = 0, pointsKnown = 0;  //---turnouts as thrown
+      uint64_t  lastThrowUs = 0, batchUs = 0;
+      unsigned  batch = 0;             //---throws started with batchUs
+      bool      power = false;         //---the driver's relay
+    };
+
+    void at(uint64_t us, uint8_t yard, uint8_t pin, uint8_t level);
+    void markAt(uint64_t us, uint8_t yard, uint8_t pair, uint8_t direction);
+    void recordEdge(uint8_t pin, uint8_t level);
+    void edge(uint64_t us, uint8_t yard, uint8_t sensor, uint8_t level);
+    void trainPass(uint64_t start, uint8_t yard, bool rev, bool outbound);
+    void start(uint8_t yard);
+    void operate();                    //---the operator's next detent or press
+    void finish(uint8_t yard);
+    void checkRoute(uint8_t yard, uint64_t setupUs);
+    void plan(uint8_t yard);           //---pick the yard's next movement
+    uint32_t rnd(uint32_t lo, uint32_t hi);
+
+    std::vector<Action> actions;       //---kept sorted by time
+    uint32_t  rng;
+    uint64_t  reactUs;                 //---allowed input-to-state time
+    bool      verbose = false;
+    TraceWriter *trace = 0;
+    Stats     st;
+
+    Lane      lanes[YARD_COUNT];
+    uint8_t   operatorYard = NO_OPERATOR;   //---yard whose movement has the knob
+    bool      pressed = false;
+    uint64_t  nextStepUs = 0;          //---next detent, or button back up
+
+    uint8_t   rec[Telemetry::RECORD_SIZE];
+    uint8_t   recLen = 0;
+};
+
+#endif
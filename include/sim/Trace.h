@@ -0,0 +1,69 @@
+//---------------------------Sensor Traces-----------------------------------
+// Recordings of the raw, undebounced detector edges, so the PassBy and
+// direction logic can be replayed off the layout against real (or
+// generated) train movements, chatter and all.
+//
+// A trace file ("*.botr") is an 8 byte header followed by one unsigned
+// LEB128 varint per record, little end first, 7 bits a byte:
+//
+//   header   "BOTR", version (2), sensor count, 2 reserved bytes
+//   record   (deltaUs << 6) | tag
+//              deltaUs    microseconds since the previous record
+//              tag 0-31   raw edge:  sensor = tag >> 1, level = tag & 1
+//              tag 32-47  MARK, a PassBy is expected here:
+//                         pair = (tag - 32) >> 1,
+//                         direction = ((tag - 32) & 1) + 1  (1 IN, 2 OUT)
+//
+// Sensor numbers are the sensorPin() order in src/main.cpp, all four
+// yards; pairs and directions are as in telemetry.  Chatter edges a few
+// hundred microseconds apart take two bytes, a typical train edge four.
+// Version 1 traces (one yard: << 4, edge tags 0-7, MARK tags 8-11) still
+// load, as yard 1.
+//
+// Traces come from the layout through tools/trace_capture.py (raw edge
+// telemetry at TELEMETRY_LEVEL 4) or from the simulated yard with
+// --record-trace.  Host only.
+//---------------------------------------------------------------------------
+
+#ifndef SIM_TRACE_H
+#define SIM_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+struct TraceRecord
+{
+  enum { EDGE, MARK };
+  uint64_t us;          //---from the start of the trace
+  uint8_t  kind;
+  uint8_t  id;          //---sensor for EDGE, pair for MARK
+  uint8_t  value;       //---level for EDGE, direction for MARK
+};
+
+class TraceWriter
+{
+  public:
+    enum { VERSION = 2, SENSORS = 16, PAIRS = 8 };
+
+    bool open(const char *path);
+    void edge(uint64_t us, uint8_t sensor, uint8_t level);
+    void mark(uint64_t us, uint8_t pair, uint8_t direction);
+    void close();
+    bool isOpen() const { return f != 0; }
+
+  private:
+    void put(uint64_t us, uint8_t tag);
+
+    FILE     *f = 0;
+    uint64_t  startUs = 0, lastUs = 0;
+    bool      started = false;
+};
+
+//---whole file into memory, false if it is not a readable trace
+bool traceLoad(const char *path, std::vector<TraceRecord> &out);
+
+//---replay engine, src/sim/SimReplay.cpp; exit status for main()
+int traceReplay(const char *path, unsigned long repeat, bool verbose);
+
+#endif
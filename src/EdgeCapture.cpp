@@ -0,0 +1,315 @@
+//---------------------------Sensor Edge Capture-----------------------------
+// See EdgeCapture.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "EdgeCapture.h"
+#include "MegaPins.h"
+
+EdgeCapture edgeCapture;
+
+//---Per port details, filled in by begin() and then only used by ISRs
+struct PortState
+{
+#if defined(__AVR__)
+  volatile uint8_t *reg;
+#endif
+  uint8_t port, mask;
+  uint8_t last;                    //---register as last read
+  uint8_t sensor[8];
+};
+
+enum { NO_SLOT = 0xFF };
+static PortState ports[EdgeCapture::MAX_PORTS];
+static uint8_t   portCount   = 0;
+static uint8_t   pcint0Slot  = NO_SLOT;   //--the PORTB entry in ports[]
+static uint8_t   pcint2Slot  = NO_SLOT;   //--the PORTK entry
+static uint8_t   polledSlots = 0;         //--bit per entry, timer sampled
+
+static inline uint8_t readPort(const PortState &p)
+{
+#if defined(__AVR__)
+  return *p.reg;
+#else
+  return simReadPort(p.port);
+#endif
+}
+
+//--one read of the port, one event per sensor bit that changed
+static inline void capturePort(PortState &p, unsigned long us)
+{
+  uint8_t now     = readPort(p);
+  uint8_t changed = (now ^ p.last) & p.mask;
+  p.last = now;
+  for (byte b = 0; changed; b++)
+  {
+    if (!(changed & _BV(b))) continue;
+    changed &= ~_BV(b);
+    edgeCapture.capture(p.sensor[b], (now >> b) & 1, us);
+  }
+}
+
+#if defined(__AVR__)
+//---Pin change interrupt for PORTB pins (10-13 and 50-53 on the Mega)
+ISR(PCINT0_vect)
+{
+  if (pcint0Slot != NO_SLOT) capturePort(ports[pcint0Slot], micros());
+}
+
+//---Pin change interrupt for PORTK pins (A8-A15)
+ISR(PCINT2_vect)
+{
+  if (pcint2Slot != NO_SLOT) capturePort(ports[pcint2Slot], micros());
+}
+
+//---Timer0 drives millis() with its overflow interrupt.  Compare match A
+//   fires once per overflow too (about every 1.024ms) and is otherwise
+//   unused, so it samples the ports that have no pin change interrupt.
+ISR(TIMER0_COMPA_vect)
+{
+  unsigned long us = micros();
+  for (byte i = 0; i < portCount; i++)
+    if (polledSlots & _BV(i)) capturePort(ports[i], us);
+}
+#else
+//---Native build: the simulator calls this whenever it changes a pin, at
+//   the simulated time of the change, just like the pin change ISR.
+static void simPinChange()
+{
+  unsigned long us = micros();
+  for (byte i = 0; i < portCount; i++) capturePort(ports[i], us);
+}
+#endif
+
+void EdgeCapture::begin(const CapturePort *portList, byte count, byte sensors,
+                        unsigned long debounceUs, unsigned long minUs, unsigned long maxUs)
+{
+  if (count > MAX_PORTS) count = MAX_PORTS;
+  if (sensors > MAX_SENSORS) sensors = MAX_SENSORS;
+  if (maxUs > 0xFFFFUL * BOUNCE_MARGIN) maxUs = 0xFFFFUL * BOUNCE_MARGIN;
+  sensorCount = sensors;
+  minWindow   = minUs;
+  maxWindow   = maxUs;
+  rawHead     = rawTail  = 0;
+  edgeHead    = edgeTail = 0;
+  rawLost     = edgeLost = rawSeen = 0;
+  portCount   = 0;
+  pcint0Slot  = pcint2Slot = NO_SLOT;
+  polledSlots = 0;
+
+  //---a sensor on no port stays clear
+  unsigned long now = micros();
+  for (byte i = 0; i < sensorCount; i++)
+  {
+    state[i].stable       = HIGH;
+    state[i].pending      = HIGH;
+    state[i].hasPending   = false;
+    state[i].pendingSince = now;
+    state[i].applied      = HIGH;
+    state[i].glitched     = false;
+    state[i].longestGlitch = debounceUs / BOUNCE_MARGIN;
+    state[i].glitches     = 0;
+  }
+
+  for (byte i = 0; i < count; i++)
+  {
+    PortState &p = ports[i];
+    p.port = portList[i].port;
+    p.mask = portList[i].mask;
+    memcpy(p.sensor, portList[i].sensor, sizeof(p.sensor));
+#if defined(__AVR__)
+    p.reg  = portInputRegister(p.port);
+#endif
+    p.last = readPort(p);
+
+    for (byte b = 0; b < 8; b++)
+    {
+      byte s = p.sensor[b];
+      if (!(p.mask & _BV(b)) || s >= sensorCount) continue;
+      state[s].stable = state[s].pending = state[s].applied = (p.last >> b) & 1;
+    }
+
+#if defined(__AVR__)
+    //---PORTB bit n is PCINTn, PORTK bit n is PCINT16+n; any other port
+    //   is polled
+    if (p.port == MEGA_PB)
+    {
+      PCMSK0 |= p.mask;
+      pcint0Slot = i;
+    }
+    else if (p.port == MEGA_PK)
+    {
+      PCMSK2 |= p.mask;
+      pcint2Slot = i;
+    }
+    else polledSlots |= _BV(i);
+#endif
+  }
+  portCount = count;
+
+#if defined(__AVR__)
+  if (pcint0Slot != NO_SLOT)
+  {
+    PCIFR |= _BV(PCIE0);     //--drop anything latched before now
+    PCICR |= _BV(PCIE0);
+  }
+  if (pcint2Slot != NO_SLOT)
+  {
+    PCIFR |= _BV(PCIE2);
+    PCICR |= _BV(PCIE2);
+  }
+  if (polledSlots)
+  {
+    OCR0A  = 0x80;
+    TIMSK0 |= _BV(OCIE0A);
+  }
+#else
+  simOnPinChange(simPinChange);
+#endif
+}
+
+//---Producer: interrupt context.  Only rawHead is written here.
+void EdgeCapture::capture(byte index, byte level, unsigned long us)
+{
+  byte next = (rawHead + 1) & (RAW_SIZE - 1);
+  if (next == rawTail)
+  {
+    rawLost++;
+    return;
+  }
+  raw[rawHead].indexLevel = (index << 1) | (level & 1);
+  raw[rawHead].us         = us;
+  rawHead = next;
+}
+
+//---Consumer: the sensor task.  Only rawTail is written here.
+void EdgeCapture::update()
+{
+  while (rawTail != rawHead)
+  {
+    RawEdge ev = raw[rawTail];
+    rawTail = (rawTail + 1) & (RAW_SIZE - 1);
+    if (rawHook) rawHook(ev.indexLevel >> 1, ev.indexLevel & 1, ev.us);
+    process(ev.indexLevel >> 1, ev.indexLevel & 1, ev.us);
+  }
+
+  //---a torn read of rawLost only costs a needless resync
+  unsigned long lost = rawLost;
+  if (lost != rawSeen)
+  {
+    rawSeen = lost;
+    resync(micros());
+  }
+  acceptDue(micros());
+}
+
+//---Some raw events were dropped: whatever the ring says, each pin is
+//   now at its live level.  One that differs from its stable level is
+//   pending from now; one back at it has nothing pending.  Neither is
+//   counted as a glitch, as what happened in between is not known.
+void EdgeCapture::resync(unsigned long now)
+{
+  acceptDue(now);
+  for (byte i = 0; i < portCount; i++)
+  {
+    const PortState &p = ports[i];
+    uint8_t live = readPort(p);
+    for (byte b = 0; b < 8; b++)
+    {
+      byte n = p.sensor[b];
+      if (!(p.mask & _BV(b)) || n >= sensorCount) continue;
+      PinState &s = state[n];
+      byte level = (live >> b) & 1;
+      if (level == s.stable) s.hasPending = false;
+      else if (!s.hasPending)
+      {
+        s.pending      = level;
+        s.pendingSince = now;
+        s.hasPending   = true;
+      }
+    }
+  }
+}
+
+void EdgeCapture::process(byte index, byte level, unsigned long us)
+{
+  //---settle everything that was already stable before this event so
+  //   edges on different pins come out in time order
+  acceptDue(us);
+
+  PinState &s = state[index];
+  if (level == s.stable)
+  {
+    if (s.hasPending)                 //--bounced back, nothing happened
+    {
+      unsigned long held = us - s.pendingSince;
+      if (held > s.longestGlitch) s.longestGlitch = held > 0xFFFF ? 0xFFFF : held;
+      if (s.glitches < 0xFFFF) s.glitches++;
+      s.glitched = true;
+    }
+    s.hasPending = false;
+  }
+  else if (!s.hasPending)
+  {
+    s.pending      = level;
+    s.pendingSince = us;
+    s.hasPending   = true;
+  }
+}
+
+//---Accept every pending level that has been stable for the debounce
+//   interval as of "now", oldest first.
+void EdgeCapture::acceptDue(unsigned long now)
+{
+  for (;;)
+  {
+    byte          oldest = MAX_SENSORS;
+    unsigned long oldestAge = 0;
+
+    for (byte i = 0; i < sensorCount; i++)
+    {
+      if (!state[i].hasPending) continue;
+      unsigned long age = now - state[i].pendingSince;
+      if (age >= window(i) && (oldest == MAX_SENSORS || age > oldestAge))
+      {
+        oldest    = i;
+        oldestAge = age;
+      }
+    }
+    if (oldest == MAX_SENSORS) return;
+
+    PinState &s = state[oldest];
+    s.stable     = s.pending;
+    s.hasPending = false;
+    if (!s.glitched) s.longestGlitch -= s.longestGlitch / 8;
+    s.glitched   = false;
+
+    byte next = (edgeHead + 1) & (EDGE_SIZE - 1);
+    if (next == edgeTail)
+    {
+      //--keep the newest; the dropped one still counts for read()
+      const SensorEdge &lost = edges[edgeTail];
+      state[lost.index].applied = lost.level;
+      edgeLost++;
+      edgeTail = (edgeTail + 1) & (EDGE_SIZE - 1);
+    }
+    edges[edgeHead].index = oldest;
+    edges[edgeHead].level = s.stable;
+    edges[edgeHead].us    = s.pendingSince;
+    edgeHead = next;
+  }
+}
+
+unsigned long EdgeCapture::window(byte index) const
+{
+  unsigned long w = (unsigned long)state[index].longestGlitch * BOUNCE_MARGIN;
+  return w < minWindow ? minWindow : w > maxWindow ? maxWindow : w;
+}
+
+bool EdgeCapture::nextEdge(SensorEdge &e)
+{
+  if (edgeTail == edgeHead) return false;
+  e = edges[edgeTail];
+  edgeTail = (edgeTail + 1) & (EDGE_SIZE - 1);
+  state[e.index].applied = e.level;
+  return true;
+}
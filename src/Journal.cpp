@@ -0,0 +1,144 @@
+//---------------------------Warm Start Journal------------------------------
+// See Journal.h for the record layout and the rules.
+//---------------------------------------------------------------------------
+
+#include "Journal.h"
+#include "MotorLink.h"              //--for its CRC-8
+
+Journal journal;
+
+//---the yard byte is invalidated first and written last (Journal.h)
+static const byte writeOrder[] = { 2, 0, 1, 3, 4, 5, 6, 7, 2 };
+
+//---a crc from 0xFF, so neither erased nor zeroed EEPROM reads as a record
+static byte recordCrc(const byte *rec)
+{
+  byte crc = 0xFF;
+  for (byte i = 0; i < Journal::RECORD - 1; i++) crc = MotorLink::crc8(crc, rec[i]);
+  return crc;
+}
+
+void Journal::begin(uint16_t at, uint16_t bytes)
+{
+  base  = at;
+  slots = bytes / RECORD;
+  next  = seq = 0;
+  writePos = STEPS;
+  records  = 0;
+  for (byte y = 0; y < MAX_YARDS; y++) have[y] = dirty[y] = false;
+
+  //---the newest record is the head; everything else is older
+  byte rec[RECORD];
+  bool any = false;
+  uint16_t newest = 0, newestSeq = 0;
+  for (uint16_t s = 0; s < slots; s++)
+  {
+    if (!read(s, rec)) continue;
+    uint16_t q = rec[0] | rec[1] << 8;
+    if (!any || (int16_t)(q - newestSeq) > 0)
+    {
+      any = true;
+      newest = s;
+      newestSeq = q;
+    }
+  }
+  if (!any) return;
+  next = (newest + 1) % slots;
+  seq  = newestSeq + 1;
+
+  //---back from the head, the first record of each yard is its newest;
+  //   anything numbered from before the ring came round is stale
+  for (uint16_t k = 0; k < slots; k++)
+  {
+    uint16_t s = (newest + slots - k) % slots;
+    if (!read(s, rec)) continue;
+    uint16_t q = rec[0] | rec[1] << 8;
+    byte y = rec[2];
+    if ((uint16_t)(newestSeq - q) >= slots || have[y]) continue;
+    JournalEntry e = { rec[3], rec[4], rec[5], rec[6] };
+    saved[y] = wanted[y] = e;
+    savedSlot[y] = s;
+    have[y] = true;
+  }
+}
+
+bool Journal::recall(byte y, JournalEntry &e) const
+{
+  if (y >= MAX_YARDS || !have[y]) return false;
+  e = saved[y];
+  return true;
+}
+
+void Journal::commit(byte y, const JournalEntry &e)
+{
+  if (y >= MAX_YARDS) return;
+  wanted[y] = e;
+  dirty[y] = !have[y] || memcmp(&e, &saved[y], sizeof(e)) != 0;
+}
+
+void Journal::service()
+{
+  if (slots == 0) return;
+  if (writePos < STEPS)
+  {
+    if (!eeprom_is_ready()) return;
+    byte i = writeOrder[writePos];
+    eeprom_write_byte((uint8_t *)(uintptr_t)(address(next) + i), writePos ? buf[i] : 0xFF);
+    if (++writePos == STEPS)
+    {
+      next = (next + 1) % slots;
+      seq++;
+      records++;
+    }
+    return;
+  }
+
+  //---a yard whose newest record the head is about to write over goes
+  //   again first, then any that have changed
+  byte pick = 0xFF;
+  uint16_t nearest = MAX_YARDS + 1;
+  for (byte y = 0; y < MAX_YARDS; y++)
+  {
+    if (!have[y]) continue;
+    uint16_t d = (savedSlot[y] + slots - next) % slots;
+    if (d < nearest)
+    {
+      nearest = d;
+      pick = y;
+    }
+  }
+  for (byte y = 0; pick == 0xFF && y < MAX_YARDS; y++)
+    if (dirty[y]) pick = y;
+  if (pick != 0xFF) start(pick);
+}
+
+//---a reset before the crc is written loses only this record; the RAM
+//   copy is taken as saved now, as a reset loses that too
+void Journal::start(byte y)
+{
+  const JournalEntry &e = wanted[y];
+  saved[y]     = e;
+  savedSlot[y] = next;
+  have[y]      = true;
+  dirty[y]     = false;
+
+  buf[0] = seq & 0xFF;
+  buf[1] = seq >> 8;
+  buf[2] = y;
+  buf[3] = e.track;
+  buf[4] = e.position;
+  buf[5] = e.known;
+  buf[6] = e.flags;
+  buf[7] = recordCrc(buf);
+
+  //---a slot that holds no record needs no invalidating
+  byte old = eeprom_read_byte((const uint8_t *)(uintptr_t)(address(next) + 2));
+  writePos = old < MAX_YARDS ? 0 : 1;
+}
+
+bool Journal::read(uint16_t slot, byte *rec) const
+{
+  for (byte i = 0; i < RECORD; i++)
+    rec[i] = eeprom_read_byte((const uint8_t *)(uintptr_t)(address(slot) + i));
+  return rec[2] < MAX_YARDS && recordCrc(rec) == rec[RECORD - 1];
+}
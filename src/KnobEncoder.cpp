@@ -0,0 +1,105 @@
+//---------------------------Track Selector Knob-----------------------------
+// See KnobEncoder.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "KnobEncoder.h"
+
+KnobEncoder knob;
+
+//---quarter step for each (previous AB << 2 | new AB); 0 for no change
+//   or an impossible double change
+static const int8_t quadSteps[16] PROGMEM = {
+   0, -1,  1,  0,
+   1,  0,  0, -1,
+  -1,  0,  0,  1,
+   0,  1, -1,  0,
+};
+
+#if defined(__AVR__)
+static volatile uint8_t *knobInReg[2];
+static uint8_t           knobMask[2];
+
+static inline void pollKnob()
+{
+  knob.sample((*knobInReg[0] & knobMask[0]) ? 1 : 0,
+              (*knobInReg[1] & knobMask[1]) ? 1 : 0, millis());
+}
+
+//---sampled once per Timer0 overflow, offset from the compare A sampling
+//   in EdgeCapture
+ISR(TIMER0_COMPB_vect)
+{
+  pollKnob();
+}
+#endif
+
+void KnobEncoder::begin(byte pinA, byte pinB)
+{
+  pinMode(pinA, INPUT_PULLUP);
+  pinMode(pinB, INPUT_PULLUP);
+  turned       = 0;
+  quarters     = 0;
+  lastDir      = 0;
+  lastDetentMs = millis();
+
+#if defined(__AVR__)
+  byte pins[2] = {pinA, pinB};
+  for (byte i = 0; i < 2; i++)
+  {
+    knobInReg[i] = portInputRegister(digitalPinToPort(pins[i]));
+    knobMask[i]  = digitalPinToBitMask(pins[i]);
+  }
+  lastAB = ((*knobInReg[0] & knobMask[0]) ? 2 : 0) | ((*knobInReg[1] & knobMask[1]) ? 1 : 0);
+
+  OCR0B   = 0x40;
+  TIMSK0 |= _BV(OCIE0B);
+#else
+  lastAB = (digitalRead(pinA) ? 2 : 0) | (digitalRead(pinB) ? 1 : 0);
+#endif
+}
+
+void KnobEncoder::sample(byte a, byte b, unsigned long ms)
+{
+  byte ab = (a << 1) | b;
+  if (ab == lastAB) return;
+  quarters += (int8_t)pgm_read_byte(&quadSteps[(lastAB << 2) | ab]);
+  lastAB = ab;
+  if (ab != 3) return;                 //---not back at rest yet
+
+  int8_t dir = quarters >= 2 ? 1 : quarters <= -2 ? -1 : 0;
+  quarters = 0;
+  if (!dir) return;                    //---wobbled and came back
+
+  //---acceleration: only for detents in a row in the same direction
+  byte gain = 1;
+  unsigned long gap = ms - lastDetentMs;
+  if (dir == lastDir)
+  {
+    if (gap < FASTER_MS) gain = 4;
+    else if (gap < FAST_MS) gain = 2;
+  }
+  lastDir      = dir;
+  lastDetentMs = ms;
+  turned      += dir * gain;
+}
+
+int KnobEncoder::take()
+{
+  noInterrupts();
+  int n  = turned;
+  turned = 0;
+  interrupts();
+  return n;
+}
+
+#if !defined(ARDUINO)
+void KnobEncoder::simTurn(int detents)
+{
+  //---clockwise is 11 -> 01 -> 00 -> 10 -> 11 (A leads B)
+  static const byte cw[4]  = {1, 0, 2, 3};
+  static const byte ccw[4] = {2, 0, 1, 3};
+  const byte *seq = detents < 0 ? ccw : cw;
+  for (int n = detents < 0 ? -detents : detents; n > 0; n--)
+    for (byte i = 0; i < 4; i++) sample(seq[i] >> 1, seq[i] & 1, millis());
+}
+#endif
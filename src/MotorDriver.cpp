@@ -0,0 +1,87 @@
+//---------------------------Motor Driver------------------------------------
+// See MotorDriver.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "MotorDriver.h"
+
+MotorDriver motorDriver;
+
+const unsigned long driverAckMs = 20;
+
+void MotorDriver::begin(Stream &port, RouteAligner::ThrowHook motor, PowerHook power,
+                        unsigned long throwMs, unsigned long settleMs, byte perStep,
+                        unsigned long staggerMs, byte firstSeq)
+{
+  powerHook = power;
+  aligner.begin(motor, throwMs, settleMs, perStep, staggerMs);
+  motorLink.begin(port, onFrame, driverAckMs, firstSeq);
+  for (byte y = 0; y < YARDS; y++)
+  {
+    tag[y] = 0;
+    moving[y] = powerWanted[y] = reportDue[y] = false;
+    setPower(y, false);
+    report(y);                       //--the panel learns the driver has started
+  }
+}
+
+void MotorDriver::poll()
+{
+  motorLink.poll();
+  aligner.service();
+  for (byte y = 0; y < YARDS; y++)
+    if (moving[y] && (long)(millis() - homeMs[y]) >= 0)
+    {
+      moving[y] = false;
+      setPower(y, powerWanted[y]);
+      report(y);
+    }
+
+  //---each STATUS is sent as the yard is when there is room for it
+  for (byte y = 0; y < YARDS; y++)
+  {
+    if (!reportDue[y]) continue;
+    DriverStatus s = { y, tag[y], aligner.position(y),
+                       (byte)((power[y] ? STATUS_POWER : 0) | (moving[y] ? STATUS_MOVING : 0)) };
+    if (!motorLink.send(LINK_STATUS, &s, sizeof(s))) break;
+    reportDue[y] = false;
+  }
+}
+
+void MotorDriver::onFrame(byte type, const byte *payload, byte len)
+{
+  MotorDriver &d = motorDriver;
+  if (type == LINK_ROUTE && len >= sizeof(RouteCommand))
+  {
+    RouteCommand c;
+    memcpy(&c, payload, sizeof(c));
+    if (c.yard >= YARDS) return;
+
+    d.powerWanted[c.yard] = false;
+    d.setPower(c.yard, false);
+    Route r = { c.reverse, c.moves };
+    unsigned long home = millis() + d.aligner.align(c.yard, r, true);
+    //---motors of a ROUTE still moving are not home any sooner for this one
+    if (!d.moving[c.yard] || (long)(home - d.homeMs[c.yard]) > 0) d.homeMs[c.yard] = home;
+    d.tag[c.yard]    = c.tag;
+    d.moving[c.yard] = true;
+    d.report(c.yard);
+  }
+  else if (type == LINK_POWER && len >= 2 && payload[0] < YARDS)
+  {
+    byte y = payload[0];
+    d.powerWanted[y] = payload[1];
+    if (!d.moving[y]) d.setPower(y, payload[1]);
+    d.report(y);
+  }
+}
+
+void MotorDriver::setPower(byte y, bool on)
+{
+  power[y] = on;
+  if (powerHook) powerHook(y, on);
+}
+
+void MotorDriver::report(byte y)
+{
+  reportDue[y] = true;
+}
@@ -0,0 +1,137 @@
+//---------------------------Motor Driver Link-------------------------------
+// See MotorLink.h for the frame layout and the rules.
+//---------------------------------------------------------------------------
+
+#include "MotorLink.h"
+
+enum { FIRST = 0x80, ACKED = 0x40, TYPE_MASK = 0x3F };
+const unsigned long breakMs = 5;     //--a frame that stops this long is dropped
+
+void MotorLink::begin(Stream &serialPort, FrameHook hook, unsigned long ackTimeoutMs,
+                      byte firstSeq)
+{
+  port      = &serialPort;
+  frameHook = hook;
+  ackMs     = ackTimeoutMs;
+  head = queued = 0;
+  txSeq     = firstSeq;
+  txStarted = onLine = false;
+  rxLast    = 0;
+  rxFirst   = rxStarted = ackDue = false;
+  rxLen     = 0;
+  sent = resends = bad = 0;
+}
+
+bool MotorLink::send(byte type, const void *payload, byte len)
+{
+  if (queued >= QUEUE || len > MAX_PAYLOAD) return false;
+  Frame &f = queue[(head + queued) % QUEUE];
+  f.type = type;
+  f.len  = len;
+  memcpy(f.payload, payload, len);
+  queued++;
+  return true;
+}
+
+void MotorLink::poll()
+{
+  while (port->available() > 0) receive(port->read());
+  if (rxLen && millis() - rxMs > breakMs) rxLen = 0;
+
+  //---take() may have acked the one on the line; the next goes at once
+  if (queued && (!onLine || millis() - sentMs >= ackMs))
+  {
+    if (onLine) resends++;
+    Frame &f = queue[head];
+    transmit(f.type, txSeq, f.payload, f.len);
+    onLine = true;
+    sentMs = millis();
+  }
+  if (ackDue) transmit(LINK_ACK, 0, 0, 0);
+}
+
+void MotorLink::receive(byte c)
+{
+  rxMs = millis();
+  if (rxLen == 0 && c != SYNC) return;
+  rx[rxLen++] = c;
+  if (rxLen < HEADER) return;
+  if (rx[4] > MAX_PAYLOAD)
+  {
+    bad++;
+    rxLen = 0;
+    return;
+  }
+  if (rxLen == HEADER + rx[4] + 1)
+  {
+    take();
+    rxLen = 0;
+  }
+}
+
+void MotorLink::take()
+{
+  byte len = rx[4];
+  byte crc = 0;
+  for (byte i = 1; i < HEADER + len; i++) crc = crc8(crc, rx[i]);
+  if (crc != rx[HEADER + len])
+  {
+    bad++;
+    return;
+  }
+
+  byte flags = rx[1], type = rx[1] & TYPE_MASK, seq = rx[2];
+  if ((flags & ACKED) && onLine && rx[3] == txSeq)
+  {
+    head = (head + 1) % QUEUE;
+    queued--;
+    txSeq++;
+    onLine    = false;
+    txStarted = true;
+  }
+  if (type == LINK_ACK) return;
+
+  //---next in order, or the first from an end that has started over;
+  //   anything else is a resend already taken
+  bool next    = rxStarted && seq == (byte)(rxLast + 1);
+  bool restart = !rxStarted || ((flags & FIRST) && (!rxFirst || seq != rxLast));
+  ackDue = true;
+  if (!next && !restart) return;
+  rxLast    = seq;
+  rxFirst   = flags & FIRST;
+  rxStarted = true;
+  if (frameHook) frameHook(type, rx + HEADER, len);
+}
+
+void MotorLink::transmit(byte type, byte seq, const byte *payload, byte len)
+{
+  byte frame[HEADER + MAX_PAYLOAD + 1];
+  frame[0] = SYNC;
+  frame[1] = type | (txStarted || type == LINK_ACK ? 0 : FIRST) | (rxStarted ? ACKED : 0);
+  frame[2] = seq;
+  frame[3] = rxLast;
+  frame[4] = len;
+  memcpy(frame + HEADER, payload, len);
+
+  byte crc = 0;
+  for (byte i = 1; i < HEADER + len; i++) crc = crc8(crc, frame[i]);
+  frame[HEADER + len] = crc;
+
+  port->write(frame, HEADER + len + 1);
+  if (rxStarted) ackDue = false;
+  sent++;
+}
+
+byte MotorLink::bootSeq(uint16_t address)
+{
+  byte boots = eeprom_read_byte((const uint8_t *)(uintptr_t)address) + 1;
+  eeprom_write_byte((uint8_t *)(uintptr_t)address, boots);
+  return boots;
+}
+
+byte MotorLink::crc8(byte crc, byte b)
+{
+  crc ^= b;
+  for (byte i = 0; i < 8; i++) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+  return crc;
+}
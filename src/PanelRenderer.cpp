@@ -0,0 +1,175 @@
+//---------------------------Panel Renderer----------------------------------
+// See PanelRenderer.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "PanelRenderer.h"
+
+//---SSD1306 command bytes used here (see the SSD1306 datasheet, 10.1)
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR   0x22
+#define CONTROL_COMMANDS   0x00
+#define CONTROL_DATA       0x40
+
+//---the power up sequence for a 128x64 panel on its internal charge pump,
+//   as Adafruit_SSD1306::begin() sends it: horizontal addressing, column
+//   and row order for a panel mounted the right way up, display on
+static const uint8_t initSequence[] PROGMEM = {
+  0xAE,             //--display off
+  0xD5, 0x80,       //--clock divide
+  0xA8, 63,         //--multiplex, 64 rows
+  0xD3, 0x00,       //--display offset
+  0x40,             //--start line 0
+  0x8D, 0x14,       //--charge pump on
+  0x20, 0x00,       //--horizontal addressing
+  0xA1,             //--segment remap
+  0xC8,             //--COM scan from the bottom
+  0xDA, 0x12,       //--COM pins
+  0x81, 0xCF,       //--contrast
+  0xD9, 0xF1,       //--precharge
+  0xDB, 0x40,       //--VCOMH deselect
+  0xA4,             //--show RAM
+  0xA6,             //--not inverted
+  0x2E,             //--no scrolling
+  0xAF,             //--display on
+};
+
+PanelRenderer::PanelRenderer(Composer composer, byte i2cAddr)
+  : compose(composer), addr(i2cAddr), wanted(0), known(0),
+    nextPage(0), spanOpen(false), spanPage(0), spanCol(0), spanEnd(0),
+    spanFrame(0), dataBytes(0), pages(0), skipped(0)
+{
+}
+
+bool PanelRenderer::begin()
+{
+  //---every transfer here is ours, so the bus can stay fast
+  Wire.setClock(400000);
+  Wire.beginTransmission(addr);
+  Wire.write(CONTROL_COMMANDS);
+  for (byte i = 0; i < sizeof(initSequence); i++)
+    Wire.write(pgm_read_byte(&initSequence[i]));
+  invalidate();
+  return Wire.endTransmission() == 0;
+}
+
+void PanelRenderer::command(uint8_t c)
+{
+  sendCommands(&c, 1);
+}
+
+void PanelRenderer::invalidate()
+{
+  known    = 0;
+  spanOpen = false;       //--a window half sent is as unknown as the rest
+}
+
+void PanelRenderer::show(uint16_t frame)
+{
+  wanted = frame;
+}
+
+bool PanelRenderer::busy() const
+{
+  if (spanOpen) return true;
+  for (byte p = 0; p < PAGES; p++)
+    if (!(known & (1 << p)) || shown[p] != wanted) return true;
+  return false;
+}
+
+//---Send changed spans, one CHUNK at a time, until the budget would be
+//   exceeded.  At least one chunk goes out per call so a budget smaller
+//   than CHUNK_US still makes progress.
+void PanelRenderer::service(unsigned long budgetUs)
+{
+  unsigned long start = micros();
+  bool first = true;
+
+  for (;;)
+  {
+    if (!spanOpen && !openNextSpan()) return;
+
+    if (!first && (micros() - start) + CHUNK_US > budgetUs) return;
+    first = false;
+    sendChunk();
+  }
+}
+
+void PanelRenderer::flushNow()
+{
+  while (busy()) service(0xFFFFFFFFUL);
+}
+
+//---Look for the next page not showing the wanted frame, compose it, and
+//   point the panel's write window at the columns that differ from what
+//   the page is showing.  The old page is composed on the stack just for
+//   the compare.
+bool PanelRenderer::openNextSpan()
+{
+  for (byte n = 0; n < PAGES; n++)
+  {
+    byte p = nextPage;
+    nextPage = (nextPage + 1) % PAGES;
+    bool have = known & (1 << p);
+    if (have && shown[p] == wanted) continue;
+
+    compose(wanted, p, page);
+    int first = 0, last = WIDTH - 1;
+    if (have)
+    {
+      uint8_t was[WIDTH];
+      compose(shown[p], p, was);
+      while (first < WIDTH && page[first] == was[first]) first++;
+      if (first == WIDTH)
+      {
+        shown[p] = wanted;      //--same pixels, nothing to send
+        skipped++;
+        continue;
+      }
+      while (page[last] == was[last]) last--;
+    }
+
+    const uint8_t window[] = { SSD1306_COLUMNADDR, (uint8_t)first, (uint8_t)last,
+                               SSD1306_PAGEADDR,   p,              p };
+    sendCommands(window, sizeof(window));
+
+    known   &= ~(1 << p);       //--half sent until the span is done
+    spanOpen  = true;
+    spanPage  = p;
+    spanCol   = first;
+    spanEnd   = last;
+    spanFrame = wanted;
+    pages++;
+    return true;
+  }
+  return false;
+}
+
+//---Send the next CHUNK of the open span.  The page buffer holds the
+//   frame as it was when the span opened; a newer frame wanted meanwhile
+//   is sent when the look comes round to this page again.
+void PanelRenderer::sendChunk()
+{
+  int  left = spanEnd - spanCol + 1;
+  byte n    = left > CHUNK ? CHUNK : left;
+
+  Wire.beginTransmission(addr);
+  Wire.write(CONTROL_DATA);
+  Wire.write(page + spanCol, n);
+  Wire.endTransmission();
+
+  dataBytes += n;
+  spanCol   += n;
+  if (n == left)
+  {
+    spanOpen = false;
+    shown[spanPage] = spanFrame;
+    known |= 1 << spanPage;
+  }
+}
+void PanelRenderer::sendCommands(const uint8_t *cmds, byte n)
+{
+  Wire.beginTransmission(addr);
+  Wire.write(CONTROL_COMMANDS);
+  Wire.write(cmds, n);
+  Wire.endTransmission();
+}
@@ -0,0 +1,88 @@
+//---------------------------Route Alignment---------------------------------
+// See RouteAligner.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "RouteAligner.h"
+
+RouteAligner routeAligner;
+
+void RouteAligner::begin(ThrowHook hook, unsigned long throwTime, unsigned long settleTime,
+                         byte motorsPerStep, unsigned long staggerTime)
+{
+  throwHook = hook;
+  throwMs   = throwTime;
+  settleMs  = settleTime;
+  perStep   = motorsPerStep;
+  staggerMs = staggerTime;
+  memset(groups, 0, sizeof(groups));
+}
+
+unsigned long RouteAligner::align(byte group, const Route &route, bool all)
+{
+  if (group >= MAX_GROUPS) return throwMs + settleMs;
+  Group &g = groups[group];
+
+  //---anything not known, or known the other way; a throw still pending
+  //   from before goes out too, as its turnout was already counted as moved
+  byte diff  = all ? route.uses : route.uses & (~g.known | (g.position ^ route.reverse));
+  g.position = (g.position & ~route.uses) | (route.reverse & route.uses);
+  g.known   |= route.uses;
+  g.moves    = g.pending | diff;
+  g.pending  = throwHook ? g.moves : 0;   //---no hook, no motors of its own to start
+
+  byte n = moved(group);
+  if (n == 0) return settleMs;
+
+  if (g.pending)
+  {
+    g.nextMs = millis();
+    start(group);
+  }
+  return throwTimeMs(n);
+}
+
+unsigned long RouteAligner::throwTimeMs(byte n) const
+{
+  if (n == 0) return settleMs;
+  byte steps = perStep ? (n + perStep - 1) / perStep : 1;
+  return (steps - 1) * staggerMs + throwMs + settleMs;
+}
+
+void RouteAligner::restore(byte group, byte position, byte known)
+{
+  if (group >= MAX_GROUPS) return;
+  Group &g = groups[group];
+  g.position = position & known;
+  g.known    = known;
+  g.pending  = g.moves = 0;
+}
+
+byte RouteAligner::moved(byte group) const
+{
+  byte n = 0;
+  for (byte p = groups[group].moves; p; p &= p - 1) n++;
+  return n;
+}
+
+void RouteAligner::service()
+{
+  for (byte i = 0; i < MAX_GROUPS; i++)
+    if (groups[i].pending && (long)(millis() - groups[i].nextMs) >= 0) start(i);
+}
+
+//---the next perStep of a group's pending turnouts, lowest first
+void RouteAligner::start(byte group)
+{
+  Group &g = groups[group];
+  byte n = 0;
+  for (byte t = 0; t < MAX_TURNOUTS && g.pending; t++)
+  {
+    byte b = 1 << t;
+    if (!(g.pending & b)) continue;
+    if (perStep && n == perStep) break;
+    g.pending &= ~b;
+    n++;
+    if (throwHook) throwHook(group, t, g.position & b);
+  }
+  g.nextMs += staggerMs;
+}
@@ -0,0 +1,125 @@
+//---------------------------Cooperative Scheduler---------------------------
+// See Scheduler.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "Scheduler.h"
+
+Scheduler::Scheduler(Task *taskList, byte taskCount)
+  : tasks(taskList), count(taskCount)
+{
+}
+
+void Scheduler::begin()
+{
+  unsigned long now = micros();
+  for (byte i = 0; i < count; i++)
+  {
+    tasks[i].lastRunUs = now - tasks[i].periodUs;  //--due on first tick
+  }
+  resetStats();
+  clearProfile();
+}
+
+void Scheduler::tick()
+{
+  unsigned long passStart = micros();
+  for (byte i = 0; i < count; i++)
+  {
+    Task &t = tasks[i];
+    unsigned long start = micros();
+    unsigned long since = start - t.lastRunUs;
+
+    if (since < t.periodUs) continue;
+
+    //---lateness is how far past the due time we got round to it
+    unsigned long late = since - t.periodUs;
+    if (late > t.maxLateUs) t.maxLateUs = late;
+    t.lateHist.add(late);
+    t.missed += late / t.periodUs;
+
+    t.lastRunUs = start;         //--no catch-up bursts after a long task
+    t.run();
+    t.runs++;
+
+    unsigned long took = micros() - start;
+    if (took > t.maxRunUs) t.maxRunUs = took;
+    t.runHist.add(took);
+  }
+  passHist.add(micros() - passStart);
+}
+
+void Scheduler::resetStats()
+{
+  for (byte i = 0; i < count; i++)
+  {
+    tasks[i].maxLateUs = 0;
+    tasks[i].maxRunUs  = 0;
+    tasks[i].runs      = 0;
+  }
+}
+
+void Scheduler::clearProfile()
+{
+  for (byte i = 0; i < count; i++)
+  {
+    tasks[i].runHist.clear();
+    tasks[i].lateHist.clear();
+    tasks[i].missed = 0;
+  }
+  passHist.clear();
+}
+
+const Task *Scheduler::find(const char *name) const
+{
+  for (byte i = 0; i < count; i++)
+    if (!strcmp(tasks[i].name, name)) return &tasks[i];
+  return 0;
+}
+
+//---------------------------Histogram----------------------------------------
+void Histogram::clear()
+{
+  memset(count, 0, sizeof(count));
+  minUs = 0xFFFFFFFFUL;
+  maxUs = 0;
+}
+
+byte Histogram::bucket(unsigned long us)
+{
+  byte b = 0;
+  while (us && b < BUCKETS - 1)
+  {
+    us >>= 1;
+    b++;
+  }
+  return b;
+}
+
+unsigned long Histogram::upperUs(byte b)
+{
+  return b >= BUCKETS - 1 ? 0xFFFFFFFFUL : (1UL << b) - 1;
+}
+
+void Histogram::add(unsigned long us)
+{
+  if (us < minUs) minUs = us;
+  if (us > maxUs) maxUs = us;
+  uint16_t &c = count[bucket(us)];
+  if (c == 0xFFFF)
+    for (byte i = 0; i < BUCKETS; i++) count[i] = (count[i] + 1) >> 1;   //--a seen bucket stays seen
+  c++;
+}
+
+unsigned long Histogram::percentileUs(byte pct) const
+{
+  unsigned long total = 0, seen = 0;
+  for (byte i = 0; i < BUCKETS; i++) total += count[i];
+  if (total == 0) return 0;
+  unsigned long want = (total * pct + 99) / 100;
+  for (byte i = 0; i < BUCKETS; i++)
+  {
+    seen += count[i];
+    if (seen >= want) return upperUs(i) < maxUs ? upperUs(i) : maxUs;
+  }
+  return maxUs;
+}
@@ -0,0 +1,120 @@
+//---------------------------Screen Layouts----------------------------------
+// See ScreenLayout.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "ScreenLayout.h"
+#include "Font5x7.h"
+
+char *formatNumber(char *buf, unsigned int value, byte width)
+{
+  buf[width] = '\0';
+  byte i = width;
+  do
+  {
+    buf[--i] = '0' + value % 10;
+    value /= 10;
+  } while (value && i);
+  while (i) buf[--i] = ' ';
+  return buf;
+}
+
+//---one glyph with its top left at (x, y), times size, clipped to the
+//   page; only the set pixels are drawn, as Adafruit_GFX does without a
+//   background colour
+static void drawChar(uint8_t *buf, byte page, int x, int y, byte size, char c)
+{
+  int top = page * 8;
+  if (y >= top + 8 || y + FONT5X7_CELL_H * size <= top) return;
+
+  for (byte i = 0; i < FONT5X7_WIDTH; i++)
+  {
+    uint8_t line = font5x7Column(c, i);
+    for (byte j = 0; line; j++, line >>= 1)
+    {
+      if (!(line & 1)) continue;
+      for (byte sy = 0; sy < size; sy++)
+      {
+        int row = y + j * size + sy - top;
+        if (row < 0 || row > 7) continue;
+        for (byte sx = 0; sx < size; sx++)
+        {
+          int col = x + i * size + sx;
+          if (col >= 0 && col < 128) buf[col] |= 1 << row;
+        }
+      }
+    }
+  }
+}
+
+void drawLayoutPage(uint8_t *buf, byte page, const ScreenLayout *layout,
+                    unsigned int value, bool named, byte yard, bool fieldsOnly)
+{
+  ScreenLayout l;
+  memcpy_P(&l, layout, sizeof(l));
+
+  for (byte i = 0; i < l.count; i++)
+  {
+    ScreenItem item;
+    memcpy_P(&item, &l.items[i], sizeof(item));
+    if (item.kind == ITEM_LABEL && fieldsOnly) continue;
+    if (item.kind == ITEM_NUMBER && named) continue;
+    if (item.kind == ITEM_NAMED && !named) continue;
+
+    char num[3];
+    const char *text = item.text;
+    bool flash = true;
+    if (item.kind == ITEM_NUMBER || item.kind == ITEM_YARD)
+    {
+      text  = item.kind == ITEM_NUMBER ? formatNumber(num, value, 2)
+                                       : formatNumber(num, yard, 1);
+      flash = false;
+    }
+
+    //---the cursor moves and wraps as print() does on the whole screen
+    byte size = item.size ? item.size : 1;
+    int  x = item.x, y = item.y;
+    for (;;)
+    {
+      char c = flash ? (char)pgm_read_byte(text++) : *text++;
+      if (!c) break;
+      if (c == '\r') continue;
+      if (c == '\n' || x + size * FONT5X7_CELL_W > 128)
+      {
+        x = 0;
+        y += size * FONT5X7_CELL_H;
+        if (c == '\n') continue;
+      }
+      drawChar(buf, page, x, y, size, c);
+      x += size * FONT5X7_CELL_W;
+    }
+  }
+}
+
+//---c < 0x80: c + 1 literal bytes follow; c >= 0x80: the next byte
+//   (c & 0x7F) + 1 times.  Runs do not stop at page edges, so the runs
+//   before the page are stepped over, which costs a byte read per run.
+void unpackScreenPage(uint8_t *buf, const uint8_t *packed, byte page)
+{
+  uint16_t skip = page * 128;
+  uint8_t *end  = buf + 128;
+  while (buf < end)
+  {
+    uint8_t c = pgm_read_byte(packed++);
+    uint16_t n = (c & 0x7F) + 1;
+    const uint8_t *run = packed;
+    packed += (c & 0x80) ? 1 : n;
+    if (skip >= n)
+    {
+      skip -= n;
+      continue;
+    }
+
+    uint16_t from = skip;
+    skip = 0;
+    n -= from;
+    if (n > end - buf) n = end - buf;
+    if (c & 0x80) memset(buf, pgm_read_byte(run), n);
+    else memcpy_P(buf, run + from, n);
+    buf += n;
+  }
+}
@@ -0,0 +1,90 @@
+//---------------------------Sensor Health-----------------------------------
+// See SensorHealth.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "SensorHealth.h"
+
+SensorHealth sensorHealth;
+
+void SensorHealth::begin(byte sensorCount, unsigned long stuckMs)
+{
+  count = sensorCount < MAX_SENSORS ? sensorCount : (byte)MAX_SENSORS;
+  stuck = stuckMs;
+  memset(sensors, 0, sizeof(sensors));
+  unsigned long now = millis();
+  for (byte i = 0; i < count; i++)
+  {
+    sensors[i].since = now;
+    sensors[i].level = HIGH;
+  }
+}
+
+//---the blocked stretch up to ms, if it is the longest yet
+void SensorHealth::noteBlocked(Sensor &s, unsigned long ms)
+{
+  unsigned long tenths = (ms - s.since) / 100;
+  if (tenths > 0xFFFF) tenths = 0xFFFF;
+  if (tenths > s.longestBlocked) s.longestBlocked = tenths;
+}
+
+bool SensorHealth::edge(byte index, byte level, unsigned long ms)
+{
+  if (index >= count) return false;
+  Sensor &s = sensors[index];
+
+  if (s.level == LOW) noteBlocked(s, ms);      //--active low
+  s.level         = level;
+  s.since         = ms;
+  s.partnerPasses = 0;
+  if (s.edges < 0xFFFF) s.edges++;
+  if (s.rate < 0xFF) s.rate++;
+
+  //---a train has gone by the partner once it clears again
+  byte p = index ^ 1;
+  if (level == HIGH && p < count && sensors[p].partnerPasses < 0xFF)
+    sensors[p].partnerPasses++;
+
+  if (s.condition == SENSOR_STUCK_BLOCKED || s.condition == SENSOR_STUCK_CLEAR)
+  {
+    s.condition = SENSOR_OK;
+    return true;
+  }
+  return false;
+}
+
+uint16_t SensorHealth::check(unsigned long ms)
+{
+  uint16_t changed = 0;
+  for (byte i = 0; i < count; i++)
+  {
+    Sensor &s = sensors[i];
+    const Sensor &partner = sensors[(i ^ 1) < count ? i ^ 1 : i];
+    byte was = s.condition;
+
+    if (s.level == LOW) noteBlocked(s, ms);
+    if (s.rate > s.busiest) s.busiest = s.rate;
+
+    if (s.rate >= CHATTER_EDGES)
+    {
+      s.condition = SENSOR_CHATTER;
+      s.quiet     = 0;
+    }
+    else if (s.condition == SENSOR_CHATTER)
+    {
+      if (s.rate >= CHATTER_EDGES / 4) s.quiet = 0;
+      else if (++s.quiet >= QUIET_S) s.condition = SENSOR_OK;
+    }
+    else if (s.condition == SENSOR_OK)
+    {
+      if (s.level == LOW && ms - s.since >= stuck && &partner != &s &&
+          partner.level == HIGH && ms - partner.since >= stuck)
+        s.condition = SENSOR_STUCK_BLOCKED;
+      else if (s.level == HIGH && s.partnerPasses >= STUCK_CLEAR_PASSES)
+        s.condition = SENSOR_STUCK_CLEAR;
+    }
+
+    s.rate = 0;
+    if (s.condition != was) changed |= 1U << i;
+  }
+  return changed;
+}
@@ -0,0 +1,64 @@
+//---------------------------Sensor Pairs------------------------------------
+// See SensorPair.h for the overview and src/main.cpp for what Busy,
+// Direction and PassBy mean.
+//---------------------------------------------------------------------------
+
+#include "SensorPair.h"
+
+void PairState::reset()
+{
+  sensTotal     = 0;
+  passByTotal   = 0;
+  busy          = 0;
+  levels        = 3;
+  direction     = 0;
+  lastDirection = 0;
+  passBy        = false;
+}
+
+//---Only a sensor whose level changed counts.  busy is the history
+//   register: bit 0 In, bit 1 Out.  While either is blocked its value is
+//   added to sensTotal, so a train that blocks In, then both, then Out
+//   alone, on its way through, leaves a total of 1 + 3 + 2 = 6.
+void PairState::update(byte inLevel, byte outLevel)
+{
+  for (byte i = 0; i < 2; i++)
+  {
+    byte level = i ? outLevel : inLevel;
+    if (level == ((levels >> i) & 1)) continue;
+
+    if (level == 0) busy = busy | (1 << i);
+    else busy = busy & ~(1 << i);
+    levels = levels ^ (1 << i);
+
+    if (busy > 0)
+    {
+      sensTotal   = sensTotal + busy;
+      passByTotal = sensTotal;
+    }
+    else sensTotal = 0;
+  }
+
+  //---PassByTotal of "6" means train has cleared the sensor success-
+  //  fully.  If train were to back out of sensors the sensors would
+  //  fire and up the count, the condition would not ever be met.
+  if (sensTotal == 0 && passByTotal == 6)
+  {
+    passBy      = true;
+    passByTotal = 0;
+  }
+  else if (sensTotal == 0) passByTotal = 0;
+
+  //--report Direction
+  if (sensTotal == 2 && busy == 2)
+  {
+    direction     = 2;
+    lastDirection = 2;
+  }
+  else if (sensTotal == 1 && busy == 1)
+  {
+    direction     = 1;
+    lastDirection = 1;
+  }
+  if (sensTotal == 0 && busy == 0) direction = 0;
+}
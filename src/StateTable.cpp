@@ -0,0 +1,101 @@
+//---------------------------Table Driven State Machine----------------------
+// See StateTable.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "StateTable.h"
+
+void StateMachine::begin(const StateTable &tableRef, byte machineId, byte initial,
+                         void (*changedHook)(byte id, byte from, byte to))
+{
+  table = &tableRef;
+  id    = machineId;
+
+  //---index the groups: rows of state s are first[s] up to first[s + 1]
+  byte stateCount = table->stateCount > MAX_STATES ? (byte)MAX_STATES : table->stateCount;
+  byte r = 0;
+  for (byte s = 0; s <= stateCount; s++)
+  {
+    while (r < table->rowCount && pgm_read_byte(&table->rows[r].state) < s) r++;
+    first[s] = r;
+  }
+
+  changed = changedHook;
+  current = initial;
+  enter(initial);
+}
+
+void StateMachine::enter(byte next)
+{
+  if (changed) changed(id, current, next);
+  current   = next;
+  enteredMs = millis();
+  memcpy_P(&timeoutMs, &table->states[next].timeoutMs, sizeof(timeoutMs));
+
+  void (*fn)(byte);
+  memcpy_P(&fn, &table->states[next].enter, sizeof(fn));
+  if (fn) fn(id);
+}
+
+bool StateMachine::dispatch(uint16_t events)
+{
+  for (byte r = first[current]; r < first[current + 1]; r++)
+  {
+    Transition t;
+    memcpy_P(&t, &table->rows[r], sizeof(t));
+    if (!(events & (1U << t.event))) continue;
+    if (t.guard != NO_GUARD && !(events & (1U << t.guard))) continue;
+
+    if (t.action)
+    {
+      void (*fn)(byte);
+      memcpy_P(&fn, &table->actions[t.action], sizeof(fn));
+      fn(id);
+    }
+    enter(t.next);
+    return true;
+  }
+  return false;
+}
+
+bool StateMachine::timedOut() const
+{
+  return timeoutMs && (millis() - enteredMs) > timeoutMs;
+}
+
+//---n-th string of a PROGMEM list of NUL separated names
+static void printName(Print &out, const char *list, byte n, byte width)
+{
+  while (n--) list += strlen_P(list) + 1;
+  byte len = strlen_P(list);
+  out.print(reinterpret_cast<const __FlashStringHelper *>(list));
+  while (len++ < width) out.print(' ');
+}
+
+void StateMachine::dump(Print &out, const StateTable &table, const char *stateNames,
+                        const char *eventNames, const char *actionNames)
+{
+  out.println(F("state         event          guard          action         next"));
+  for (byte r = 0; r < table.rowCount; r++)
+  {
+    Transition t;
+    memcpy_P(&t, &table.rows[r], sizeof(t));
+    printName(out, stateNames, t.state, 14);
+    printName(out, eventNames, t.event, 15);
+    if (t.guard == NO_GUARD) out.print(F("-              "));
+    else printName(out, eventNames, t.guard, 15);
+    if (t.action) printName(out, actionNames, t.action, 15);
+    else out.print(F("-              "));
+    printName(out, stateNames, t.next, 0);
+    out.println();
+  }
+  for (byte s = 0; s < table.stateCount; s++)
+  {
+    unsigned long limit;
+    memcpy_P(&limit, &table.states[s].timeoutMs, sizeof(limit));
+    if (!limit) continue;
+    printName(out, stateNames, s, 14);
+    out.print(F("times out after "));
+    out.print(limit);
+    out.println(F(" ms"));
+  }
+}
@@ -0,0 +1,54 @@
+//---------------------------Event Telemetry---------------------------------
+// See Telemetry.h for the record layout.
+//---------------------------------------------------------------------------
+
+#include "Telemetry.h"
+
+Telemetry telemetry;
+
+void Telemetry::begin(HardwareSerial &serialPort)
+{
+  port      = &serialPort;
+  seq       = 0;
+  lost      = 0;
+  totalLost = 0;
+}
+
+void Telemetry::emit(byte type, byte id, byte val8, uint16_t val16, unsigned long us)
+{
+  if (!port) return;
+
+  //---report earlier losses first, so the log shows where the gap is
+  if (lost && send(TLM_DROPPED, 0, 0, lost, us)) lost = 0;
+
+  if (!send(type, id, val8, val16, us))
+  {
+    if (lost < 0xFFFF) lost++;
+    totalLost++;
+  }
+}
+
+bool Telemetry::send(byte type, byte id, byte val8, uint16_t val16, unsigned long us)
+{
+  if (port->availableForWrite() < RECORD_SIZE) return false;
+
+  byte rec[RECORD_SIZE];
+  rec[0]  = SYNC;
+  rec[1]  = type;
+  rec[2]  = seq++;
+  rec[3]  = id;
+  rec[4]  = val8;
+  rec[5]  = val16 & 0xFF;
+  rec[6]  = val16 >> 8;
+  rec[7]  = us & 0xFF;
+  rec[8]  = (us >> 8) & 0xFF;
+  rec[9]  = (us >> 16) & 0xFF;
+  rec[10] = (us >> 24) & 0xFF;
+
+  byte check = 0;
+  for (byte i = 1; i < RECORD_SIZE - 1; i++) check ^= rec[i];
+  rec[11] = check;
+
+  port->write(rec, RECORD_SIZE);
+  return true;
+}
@@ -0,0 +1,64 @@
+//---------------------------Train Speed and Length--------------------------
+// See TrainGauge.h for the overview.
+//---------------------------------------------------------------------------
+
+#include "TrainGauge.h"
+
+TrainGauge trainGauge;
+
+void TrainGauge::begin(const uint16_t *spacingMm, byte pairs)
+{
+  spacing   = spacingMm;
+  pairCount = pairs < MAX_PAIRS ? pairs : (byte)MAX_PAIRS;
+  memset(blockedUs, 0, sizeof(blockedUs));
+  memset(clearedUs, 0, sizeof(clearedUs));
+}
+
+void TrainGauge::edge(byte sensor, byte level, unsigned long us)
+{
+  if (sensor >= pairCount * 2) return;
+  if (level == 0) blockedUs[sensor] = us;   //--active low
+  else clearedUs[sensor] = us;
+}
+
+bool TrainGauge::measure(byte pair, byte direction, TrainMeasure &m) const
+{
+  if (pair >= pairCount || spacing[pair] == 0) return false;
+
+  //---INBOUND trains block the In sensor first
+  byte first  = pair * 2 + (direction == 1 ? 0 : 1);
+  byte second = pair * 2 + (direction == 1 ? 1 : 0);
+
+  //---all differences, so micros() wrapping between edges is harmless
+  unsigned long lead = blockedUs[second] - blockedUs[first];
+  unsigned long tail = clearedUs[second] - clearedUs[first];
+  unsigned long occ  = (clearedUs[first] - blockedUs[first]) +
+                       (clearedUs[second] - blockedUs[second]);
+
+  //---the pass the logic saw has nose and tail in this order; anything
+  //   else (a stale time, a bounce) and no measurement
+  const unsigned long LIMIT = 0x3FFFFFFFUL;       //--about 18 minutes
+  if (lead == 0 || tail == 0 || lead > LIMIT || tail > LIMIT || occ > 2 * LIMIT)
+    return false;
+  unsigned long cross = lead + tail;
+  if (cross < 1000 || occ < cross) return false;  //--faster than 100m/s, or
+                                                  //  shorter than the spacing
+  unsigned long s = spacing[pair];
+  unsigned long speed = 2000000UL * s / cross;
+
+  //---s * occ / cross, scaled down until the product fits
+  while (occ > 0xFFFFFFFFUL / s)
+  {
+    occ   >>= 1;
+    cross >>= 1;
+  }
+  if (cross == 0) return false;
+  unsigned long length = s * occ / cross;
+
+  m.pair      = pair;
+  m.direction = direction;
+  m.speedMmS  = speed > 0xFFFF ? 0xFFFF : (uint16_t)speed;
+  m.lengthMm  = length > 0xFFFF ? 0xFFFF : (uint16_t)length;
+  m.us        = clearedUs[second];
+  return true;
+}
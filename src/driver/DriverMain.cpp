@@ -0,0 +1,73 @@
+//B&O McKenzie Division - Staging Yard Project: MotorMan driver Pro-Mini
+//
+//---------------------------Motor Driver Sketch-----------------------------
+// The second Pro-Mini of the staging panel.  It takes the panel's ROUTE
+// and POWER frames over its serial port (MotorLink.h) and drives the
+// rr-CirKits MotorMan inputs of every yard's ladder turnouts and the
+// track power relay of each yard (MotorDriver.h).
+//
+// The Pro-Mini has too few pins for 20 motors and 4 relays, so the
+// outputs are a chain of three 74HC595s on the SPI pins, one bit each:
+//
+//   bits  0- 7   yards 1 and 2, turnouts 0-3 (set: reverse)
+//   bits  8-15   yards 3 and 4, turnouts 0-3
+//   bits 16-19   turnout 4 of yards 1-4
+//   bits 20-23   track power of yards 1-4 (set: on)
+//
+// Built on its own (pio run -e promini); the native build runs the same
+// MotorDriver in the simulator instead.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "MotorDriver.h"
+#include "LinkConfig.h"
+
+#define latchPin 10
+#define dataPin  11
+#define clockPin 13
+
+unsigned long outputs = 0;           //--the shift register image
+
+const uint16_t linkBootAddr = 0;     //--the link's count of boots (MotorLink.h)
+
+void latchOutputs()
+{
+  digitalWrite(latchPin, LOW);
+  for (char i = 2; i >= 0; i--) shiftOut(dataPin, clockPin, MSBFIRST, outputs >> (i * 8));
+  digitalWrite(latchPin, HIGH);
+}
+
+void setOutput(byte n, bool on)
+{
+  if (on) outputs |= 1UL << n;
+  else outputs &= ~(1UL << n);
+  latchOutputs();
+}
+
+void throwMotor(byte yard, byte turnout, bool reverse)
+{
+  if (turnout < 4) setOutput(yard * 4 + turnout, reverse);
+  else if (turnout == 4) setOutput(16 + yard, reverse);
+}
+
+void trackPower(byte yard, bool on)
+{
+  setOutput(20 + yard, on);
+}
+
+void setup()
+{
+  pinMode(latchPin, OUTPUT);
+  pinMode(dataPin, OUTPUT);
+  pinMode(clockPin, OUTPUT);
+  latchOutputs();
+
+  Serial.begin(linkBaud);
+  motorDriver.begin(Serial, throwMotor, trackPower, tortiThrowMs, tortiSettleMs,
+                    tortiPerStep, tortiStaggerMs, MotorLink::bootSeq(linkBootAddr));
+}
+
+void loop()
+{
+  motorDriver.poll();
+}
@@ -48,17 +48,29 @@
 //
 //   Sensor Busy - Sensor reports busy when either of the sensor pair is true
 //   and remains so only until the both go false.
+//
+// All four yards run at once from this one board, each with its own state
+// machine, sensor pairs and tracks (include/Yard.h); the knob, button,
+// bail out switch and display are shared and follow the yard the knob
+// points into.
 //---------------------------------------------------------------------------
 
-#include <Arduino.h>
-#include <RotaryEncoder.h>
-#include <Bounce2.h>
-#include <SPI.h>
-#include <Wire.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-
-//------------Setup sensor debounce from Bounce2 library-----
+#include "Hal.h"
+#include "Scheduler.h"
+#include "EdgeCapture.h"
+#include "SensorHealth.h"
+#include "PanelRenderer.h"
+#include "Telemetry.h"
+#include "StateTable.h"
+#include "Yard.h"
+#include "SensorPair.h"
+#include "MotorLink.h"
+#include "KnobEncoder.h"
+#include "ScreenLayout.h"
+#include "ScreenBitmaps.h"
+
+//------------Sensor pins, captured and debounced by EdgeCapture-----
+//  Yard 1 as before; yards 2-4 on the other pin change capable inputs.
 #define mainSensInpin 11
 #define mainSensOutpin 12
 #define revSensInpin 10 
@@ -74,88 +86,337 @@
 #define trackPowerLED_PIN 7  //debug
 
 
-// Instantiate a Bounce object
-Bounce debouncer1 = Bounce(); Bounce debouncer2 = Bounce(); 
-Bounce debouncer3 = Bounce(); Bounce debouncer4 = Bounce();
+//---main and rev pair of each yard.  The port bits are worked out at
+//   compile time, and EdgeCapture reads each port register once per edge
+//   or tick for all the pairs on it (see SensorPair.h).
+typedef SensorBank<
+  SensorPair<mainSensInpin, mainSensOutpin>, SensorPair<revSensInpin, revSensOutpin>,  //--yard 1
+  SensorPair<50, 51>,   SensorPair<52, 53>,                                             //--yard 2
+  SensorPair<A8, A9>,   SensorPair<A10, A11>,                                           //--yard 3
+  SensorPair<A12, A13>, SensorPair<NO_PIN, NO_PIN>                                      //--yard 4, no reverse loop
+> YardSensors;
+static_assert((int)YardSensors::SENSORS == (int)SENSOR_COUNT, "two pairs per yard");
+
+const CapturePort capturePorts[] = {
+  YardSensors::port(MEGA_PB),     //--10-12, 50-53: pin change interrupt
+  YardSensors::port(MEGA_PH),     //--9: no pin change interrupt, polled
+  YardSensors::port(MEGA_PK),     //--A8-A13: pin change interrupt
+};
+static_assert(YardSensors::pinsOn(MEGA_PB) + YardSensors::pinsOn(MEGA_PH) +
+              YardSensors::pinsOn(MEGA_PK) == YardSensors::pinCount(),
+              "a sensor is on a port missing from capturePorts");
+
+byte sensorPin(byte sensor) { return YardSensors::pin(sensor); }
+
+//---Busy, Direction and PassBy of all eight pairs, advanced together
+PairBank<byte> pairBank;
+static_assert((int)YardSensors::PAIRS <= (int)PairBank<byte>::LANES, "one bit per pair");
+byte pairLevels[2] = {0xFF, 0xFF};   //--In, Out of each pair as last edged
+unsigned long edgeLostSeen = 0;     //--edgeCapture.edgeOverruns() as last synced
+
+//---mm between the In and Out detector of each pair, for train speed and
+//   length (TrainGauge.h); main, rev of each yard, 0 where none is fitted
+const uint16_t pairSpacingMm[PAIR_COUNT] = {
+  50, 50,      //--yard 1
+  50, 50,      //--yard 2
+  50, 50,      //--yard 3
+  50, 0,       //--yard 4, no reverse loop
+};
+
+//---Each sensor's debounce window follows its own glitches (EdgeCapture.h)
+//   between the minimum and maximum; it starts at sensDebounceUs.  A
+//   sensor blocked for sensStuckMs with its partner clear is stuck, and
+//   the yard stops believing it (SensorHealth.h).
+const unsigned long sensDebounceUs    = 5000;
+const unsigned long sensDebounceMinUs = 2000;
+const unsigned long sensDebounceMaxUs = 20000;
+const unsigned long sensStuckMs       = 300000UL;
+unsigned long healthCheckMs;
+byte healthNext;                         //--next sensor for the stats records
 
 //------------Set up OLED Screen-----
-#define SCREEN_WIDTH 128 // OLED display width, in pixels
-#define SCREEN_HEIGHT 64 // OLED display height, in pixels
-
-//-------Declaration for an SSD1306 display - using I2C (SDA, SCL pins)
+//-------SSD1306 128x64 display - using I2C (SDA, SCL pins), no frame
+//  buffer: the renderer composes a page at a time (composePage()).
 #define OLED_RESET     4 // Reset pin # (or -1 if sharing Arduino reset pin)
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#define OLED_ADDR   0x3C // Address 0x3D for 128x64
+void composePage(uint16_t frame, byte page, uint8_t *buf);
+PanelRenderer panel(composePage, OLED_ADDR);   //--sends only changed pages
+
+//---The yards never wait on the panel: a missing one is looked for again
+//   every displayRetryMs, and the splash shows for splashMs while the
+//   state machine already runs.
+const unsigned long splashMs       = 5000;
+const unsigned long displayRetryMs = 1000;
+bool displayUp = false, splashing = false;
+unsigned long splashUntilMs, displayProbeMs;
+void startDisplay();
 
 //--RotaryEncoder DEFINEs for numbers of tracks to access with encoder
 #define ROTARYSTEPS 1
 #define ROTARYMIN   7
 #define ROTARYMAX  12
 
-
-
-
-
-//--- Setup a RotaryEncoder for pins A2 and A3:
-RotaryEncoder encoder(A2, A3);
-byte lastPos = -1;                //--- Last known rotary position.
+//---tracks of each yard; past the last track of one yard the knob goes
+//   on to the first track of the next
+//---lead and ladder: mm from the main pair to the first track's clearance
+//   point, and between the clearance points of neighbouring tracks
+const YardInfo yardInfo[YARD_COUNT] = {
+  { ROTARYMIN, ROTARYMAX,     true,  600, 200 },
+  { ROTARYMIN, ROTARYMAX,     true,  600, 200 },
+  { ROTARYMIN, ROTARYMAX,     true,  600, 200 },
+  { ROTARYMIN, ROTARYMAX - 1, false, 600, 200 },
+};
+
+//---turnouts each track's route goes over, and which way (RouteAligner.h),
+//   by track - firstTrack.  Each yard's lead is a ladder: turnout n
+//   diverges to track 7 + n, and the tracks past it run straight through.
+//        reverse  uses
+const Route yardRoutes[YARD_COUNT][MAX_YARD_TRACKS] PROGMEM = {
+  { {0x01, 0x01}, {0x02, 0x03}, {0x04, 0x07}, {0x08, 0x0F}, {0x10, 0x1F}, {0x00, 0x1F} },
+  { {0x01, 0x01}, {0x02, 0x03}, {0x04, 0x07}, {0x08, 0x0F}, {0x10, 0x1F}, {0x00, 0x1F} },
+  { {0x01, 0x01}, {0x02, 0x03}, {0x04, 0x07}, {0x08, 0x0F}, {0x10, 0x1F}, {0x00, 0x1F} },
+  { {0x01, 0x01}, {0x02, 0x03}, {0x04, 0x07}, {0x08, 0x0F}, {0x00, 0x0F}, {0x00, 0x00} },
+};                                        //--yard 4: track 11 ends the ladder
+static_assert(ROTARYMAX - ROTARYMIN + 1 <= MAX_YARD_TRACKS, "a route for every track");
+static_assert(ROTARYMAX < 16 && ROUTE_QUEUE < 4, "Yard's bitfields are too narrow");
+
+
+
+
+
+//--- The rotary encoder on pins A2 and A3 is decoded by KnobEncoder from
+//    interrupt context.  A2/A3 have no pin change interrupt and PCINT2
+//    (A8-A15) is the yard sensors' on A8-A13, so the knob is sampled
+//    from the Timer0 compare B interrupt, about every 1ms.
+#define knobPinA A2
+#define knobPinB A3
 const int rotarySwitch = 2;      //---Setup Rotary Encoder switch on 
                                  //   pin D2 - active low ----------- 
 
 //------RotaryEncoder Setup and variables are in this section---------
-byte tracknumChoice  = ROTARYMAX;
-byte tracknumActive  = ROTARYMAX;
-byte tracknumDisplay = ROTARYMAX;
-byte tracknumLast    = ROTARYMAX;
+//  The tracks themselves are per yard, in yards[].
+byte focusYard    = 0;          //--the yard the knob points into
 
 //Rotary Encoder Switch Variables
-byte knobPosition = ROTARYMAX;
 bool knobToggle   = true;       //active low 
+bool knobWas      = true;       //--as of the last state tick, for presses
+bool knobPress    = false;      //--went down on this state tick
 void readEncoder();           //--RotaryEncoder Function------------------
+bool namedTrack(byte yard, byte track);
 
 //---Timer Variables---
+//---Turnout motors: timed as in LinkConfig.h, shared with the driver.  A
+//   route that moves nothing still waits tortiSettleMs.  The driver times
+//   the motors; the panel works out the same window and gives the driver
+//   linkMarginMs past it to confirm before powering up regardless.
+//   tortiTimerInterval is where TRACK_SETUP starts before
+//   enterTRACK_SETUP() sizes it.
 const long tortiTimerInterval   = 1000 * 4;
-const long trainTimerInterval   = 1000 * 15 * 1;
-const long displayTimerInterval = 1000 * 10 * 1;
-unsigned long startDisplayTime  = 0;
+const unsigned long linkMarginMs   = 500;
+const long trainTimerInterval   = 1000 * 15 * 1;   //--TRACK_ACTIVE until fitHold() fits it
+
+//---Warm start journal (Journal.h): the first 1KB of the EEPROM, 128 records
+const uint16_t journalBase  = 0;
+const uint16_t journalBytes = 1024;
+void pollJournal();
+bool resumeYard(byte yard, byte &startState);
+
+//---Link to the MotorMan driver Pro-Mini (MotorLink.h) on Serial1, at
+//   linkBaud (LinkConfig.h); its count of boots is kept past the journal
+const unsigned long linkAckMs = 20;
+const uint16_t linkBootAddr   = journalBase + journalBytes;
+MotorLink motorLink;
+void onDriverFrame(byte type, const byte *payload, byte len);
+void setRailPower(byte yard, byte level);
+void sendPending(byte yard);
+
+//---TRACK_ACTIVE hold, fitted to the train (see fitHold())
+const unsigned long holdSettleMs = 2000;    //--braking to a stand once in the track
+const unsigned long holdMovingMs = 3000;    //--busy sensors that edged this recently
+const unsigned long holdMaxMs    = 60000;   //--never hold longer
 
 
 //---------------------OLED Display Functions------------------//
-void bandoText(String text, int x, int y, int size, boolean d);
+//---Screens are requested by the state functions and drawn by the
+//   display task, so a redraw never holds up a state tick.  Each yard
+//   remembers the screen it last asked for; the panel shows the focus
+//   yard's.
+enum Screen {SCREEN_NONE, SCREEN_SPLASH, SCREEN_HOUSEKEEP, SCREEN_SELECT,
+             SCREEN_ALIGNING, SCREEN_PROCEED, SCREEN_OCCUPIED, SCREEN_BLANK,
+             SCREEN_COUNT};
+static_assert(SCREEN_COUNT <= 16, "Yard::screen is 4 bits");
+Screen screenPending = SCREEN_NONE;
+void requestScreen(byte yard, Screen s);
+void drawScreen(Screen s);
+
+//---Screen layouts (ScreenLayout.h), all in flash.  Labels used on more
+//   than one screen are stored once.
+constexpr char txtBandO[]     PROGMEM = "B&O RAIL";
+constexpr char txtJeroen[]    PROGMEM = "JEROEN GARRITSEN'S";
+constexpr char txtMcKenzie[]  PROGMEM = "McKENZIE";
+constexpr char txtDivision[]  PROGMEM = "DIVISION";
+constexpr char txtSelectNow[] PROGMEM = "SELECT NOW";
+constexpr char txtTrack[]     PROGMEM = "TRACK";
+constexpr char txtRevL[]      PROGMEM = "RevL";
+constexpr char txtPushButton[] PROGMEM = "PUSH BUTTON TO SELECT";
+constexpr char txtPowerHK[]   PROGMEM = "TRACK POWER  -HK-";
+constexpr char txtPowerOff[]  PROGMEM = "TRACK POWER  -OFF-";
+constexpr char txtPowerOn[]   PROGMEM = "TRACK POWER  -ON-";
+constexpr char txtAligning[]  PROGMEM = "ALIGNING";
+constexpr char txtNiceDay[]   PROGMEM = "HAVE A NICE DAY";
+constexpr char txtProceed[]   PROGMEM = "PROCEED ";
+constexpr char txtTimerOn[]   PROGMEM = "TIMER ON";
+constexpr char txtYardLead[]  PROGMEM = "YARD LEAD";
+constexpr char txtOccupied[]  PROGMEM = "OCCUPIED";
+constexpr char txtStop[]      PROGMEM = "STOP!";
+constexpr char txtYard[]      PROGMEM = "YARD";
+
+constexpr ScreenItem splashItems[] PROGMEM = {
+  { txtBandO,      25,  0, 2, ITEM_LABEL  },
+  { txtJeroen,      8, 20, 1, ITEM_LABEL  },
+  { txtMcKenzie,    0, 33, 2, ITEM_LABEL  },
+  { txtDivision,   30, 50, 2, ITEM_LABEL  },
+};
+constexpr ScreenItem housekeepItems[] PROGMEM = {
+  { txtSelectNow,   0,  0, 2, ITEM_LABEL  },
+  { txtTrack,       0, 20, 2, ITEM_LABEL  },
+  { txtRevL,       70, 20, 2, ITEM_NAMED  },
+  { 0,             80, 20, 2, ITEM_NUMBER },
+  { txtYard,        0, 37, 1, ITEM_LABEL  },
+  { 0,             30, 37, 1, ITEM_YARD   },
+  { txtPushButton,  0, 46, 1, ITEM_LABEL  },
+  { txtPowerHK,     0, 56, 1, ITEM_LABEL  },
+};
+constexpr ScreenItem selectItems[] PROGMEM = {
+  { txtSelectNow,   0,  0, 2, ITEM_LABEL  },
+  { txtTrack,       0, 20, 2, ITEM_LABEL  },
+  { txtRevL,       70, 20, 2, ITEM_NAMED  },
+  { 0,             80, 20, 2, ITEM_NUMBER },
+  { txtYard,        0, 37, 1, ITEM_LABEL  },
+  { 0,             30, 37, 1, ITEM_YARD   },
+  { txtPushButton,  0, 46, 1, ITEM_LABEL  },
+  { txtPowerOff,    0, 56, 1, ITEM_LABEL  },
+};
+constexpr ScreenItem aligningItems[] PROGMEM = {
+  { txtAligning,    0,  0, 2, ITEM_LABEL  },
+  { txtTrack,       0, 20, 2, ITEM_LABEL  },
+  { txtRevL,       70, 20, 2, ITEM_NAMED  },
+  { 0,             80, 20, 2, ITEM_NUMBER },
+  { txtYard,        0, 37, 1, ITEM_LABEL  },
+  { 0,             30, 37, 1, ITEM_YARD   },
+  { txtNiceDay,     0, 46, 1, ITEM_LABEL  },
+  { txtPowerOff,    0, 56, 1, ITEM_LABEL  },
+};
+constexpr ScreenItem proceedItems[] PROGMEM = {
+  { txtProceed,    20,  0, 2, ITEM_LABEL  },
+  { txtTimerOn,     0, 20, 2, ITEM_LABEL  },
+  { txtYard,        0, 37, 1, ITEM_LABEL  },
+  { 0,             30, 37, 1, ITEM_YARD   },
+  { txtPowerOn,     0, 56, 1, ITEM_LABEL  },
+};
+constexpr ScreenItem occupiedItems[] PROGMEM = {
+  { txtYardLead,    0,  0, 2, ITEM_LABEL  },
+  { txtOccupied,    0, 20, 2, ITEM_LABEL  },
+  { txtStop,       20, 42, 2, ITEM_LABEL  },
+  { txtYard,       86, 46, 1, ITEM_LABEL  },
+  { 0,            116, 46, 1, ITEM_YARD   },
+};
+
+//---indexed by Screen; NONE and BLANK draw nothing
+constexpr ScreenLayout screenLayouts[SCREEN_COUNT] PROGMEM = {
+  { 0, 0 },
+  SCREEN_LAYOUT(splashItems),
+  SCREEN_LAYOUT(housekeepItems),
+  SCREEN_LAYOUT(selectItems),
+  SCREEN_LAYOUT(aligningItems),
+  SCREEN_LAYOUT(proceedItems),
+  SCREEN_LAYOUT(occupiedItems),
+  { 0, 0 },
+};
 
 //---------------SETUP STATE Machine and State Functions----------------------
-enum {HOUSEKEEP, STAND_BY, TRACK_SETUP, TRACK_ACTIVE, OCCUPIED,} mode;
-void runHOUSEKEEP();
-void runSTAND_BY();
-void runTRACK_SETUP();
-void runTRACK_ACTIVE();
-void runOCCUPIED();
-
-void leaveTrack_Setup();
-void leaveTrack_Active();
-
-
-//---State Machine Variables
-byte railPower = ON;
-
-//---Sensor variables
-byte mainSensTotal      = 0, mainSens_Report = 0; 
-byte mainPassByState    = false, mainPassByTotal = 0;
-byte mainInValue        = 1, mainIn_LastValue = 1; 
-byte mainOutValue       = 1, mainOut_LastValue = 1;
-byte main_LastDirection = 0;
-byte mainDirection      = 0;
-
-byte revSensTotal       = 0, revSens_Report = 0; 
-byte revPassByState     = false; 
-byte revPassByTotal     = 0;
-byte revInValue         = 1;
-byte revIn_LastValue    = 1; 
-byte revOutValue        = 1, revOut_LastValue = 1;
-byte revDirection       = 0;
-byte rev_LastDirection  = 0;
-
-bool entry_ExitBusy = false;
-//----end of sensor variables
+//  The yard is a table driven state machine (StateTable.h).  Every way out
+//  of a state is a row of yardTransitions[] and the one-time work on
+//  entering a state is that state's enter function.  Each state tick
+//  turns the inputs into events and dispatches them once, so no state
+//  function ever calls another.  Every yard runs its own machine off the
+//  same table; the state functions get the yard number.
+enum Mode {HOUSEKEEP, STAND_BY, TRACK_SETUP, TRACK_ACTIVE, OCCUPIED, MODE_COUNT};
+enum Event {EV_ALWAYS, EV_SENSOR_BUSY, EV_SENSORS_CLEAR, EV_KNOB_PRESS,
+            EV_TIMEOUT, EV_TRAIN_GONE, EV_BAIL_OUT, EV_ROUTE_QUEUED, EV_ROUTE_SET,
+            EVENT_COUNT};
+enum Action {ACT_NONE, ACT_RAIL_POWER_ON, ACT_RELEASE, ACT_BAIL_OUT, ACT_NEXT_ROUTE,
+             ACTION_COUNT};
+const byte NO_GUARD = StateMachine::NO_GUARD;
+
+void enterHOUSEKEEP(byte yard);
+void enterTRACK_SETUP(byte yard);
+void enterTRACK_ACTIVE(byte yard);
+void enterOCCUPIED(byte yard);
+void railPowerOn(byte yard);
+void releaseTrack(byte yard);
+void bailOutTrack(byte yard);
+void nextRoute(byte yard);
+void queueRoute(byte yard, byte track);
+void fitHold(byte yard);
+void trainMeasured(byte yard, const TrainMeasure &m);
+uint16_t pollEvents(byte yard);
+void dumpStates(Print &out);
+
+//---grouped by state, in state order; within a state the first row that
+//   matches wins, so STAND_BY looks for a busy sensor before a queued
+//   route or the knob, and a queued route is only taken with the lead
+//   clear - in HOUSEKEEP, or later in STAND_BY if the lead was busy then
+const Transition yardTransitions[] PROGMEM = {
+//  state         event             guard             action             next
+  { HOUSEKEEP,    EV_ROUTE_QUEUED,  EV_SENSORS_CLEAR, ACT_NEXT_ROUTE,    TRACK_SETUP  },
+  { HOUSEKEEP,    EV_ALWAYS,        NO_GUARD,         ACT_NONE,          STAND_BY     },
+  { STAND_BY,     EV_SENSOR_BUSY,   NO_GUARD,         ACT_NONE,          OCCUPIED     },
+  { STAND_BY,     EV_ROUTE_QUEUED,  EV_SENSORS_CLEAR, ACT_NEXT_ROUTE,    TRACK_SETUP  },
+  { STAND_BY,     EV_KNOB_PRESS,    NO_GUARD,         ACT_NONE,          TRACK_SETUP  },
+  { TRACK_SETUP,  EV_ROUTE_SET,     EV_SENSOR_BUSY,   ACT_RAIL_POWER_ON, OCCUPIED     },
+  { TRACK_SETUP,  EV_ROUTE_SET,     NO_GUARD,         ACT_RAIL_POWER_ON, TRACK_ACTIVE },
+  { TRACK_SETUP,  EV_TIMEOUT,       EV_SENSOR_BUSY,   ACT_RAIL_POWER_ON, OCCUPIED     },
+  { TRACK_SETUP,  EV_TIMEOUT,       NO_GUARD,         ACT_RAIL_POWER_ON, TRACK_ACTIVE },
+  { TRACK_ACTIVE, EV_TRAIN_GONE,    EV_SENSOR_BUSY,   ACT_RELEASE,       OCCUPIED     },
+  { TRACK_ACTIVE, EV_TRAIN_GONE,    NO_GUARD,         ACT_RELEASE,       HOUSEKEEP    },
+  { TRACK_ACTIVE, EV_BAIL_OUT,      EV_SENSOR_BUSY,   ACT_BAIL_OUT,      OCCUPIED     },
+  { TRACK_ACTIVE, EV_BAIL_OUT,      NO_GUARD,         ACT_BAIL_OUT,      HOUSEKEEP    },
+  { TRACK_ACTIVE, EV_TIMEOUT,       EV_SENSOR_BUSY,   ACT_RELEASE,       OCCUPIED     },
+  { TRACK_ACTIVE, EV_TIMEOUT,       NO_GUARD,         ACT_RELEASE,       HOUSEKEEP    },
+  { OCCUPIED,     EV_SENSORS_CLEAR, NO_GUARD,         ACT_NONE,          HOUSEKEEP    },
+};
+
+//---rail power stays off until the driver has the route home, or past the
+//   time it should take (set by enterTRACK_SETUP());
+//   a track is held for trainTimerInterval unless the train leaves first,
+//   or fitHold() has fitted the hold to the train
+const StateInfo yardStates[MODE_COUNT] PROGMEM = {
+  { enterHOUSEKEEP,    0 },
+  { 0,                 0 },
+  { enterTRACK_SETUP,  (unsigned long)tortiTimerInterval },
+  { enterTRACK_ACTIVE, (unsigned long)trainTimerInterval },
+  { enterOCCUPIED,     0 },
+};
+
+void (* const yardActions[ACTION_COUNT])(byte) PROGMEM =
+  { 0, railPowerOn, releaseTrack, bailOutTrack, nextRoute };
+
+const char yardStateNames[] PROGMEM =
+  "HOUSEKEEP\0STAND_BY\0TRACK_SETUP\0TRACK_ACTIVE\0OCCUPIED";
+const char yardEventNames[] PROGMEM =
+  "ALWAYS\0SENSOR_BUSY\0SENSORS_CLEAR\0KNOB_PRESS\0TIMEOUT\0TRAIN_GONE\0BAIL_OUT\0"
+  "ROUTE_QUEUED\0ROUTE_SET";
+const char yardActionNames[] PROGMEM = "-\0RAIL_POWER_ON\0RELEASE\0BAIL_OUT\0NEXT_ROUTE";
+
+const StateTable yardTable = {
+  yardTransitions, sizeof(yardTransitions) / sizeof(yardTransitions[0]),
+  yardStates, MODE_COUNT, yardActions
+};
+
+
+//---State Machine and Sensor Variables, one set per yard (Yard.h)
+Yard yards[YARD_COUNT];
 
 //DEBUG SECTION
 
@@ -167,13 +428,81 @@ byte      bailOut = 1;  //active low
 
 
 //---Sensor Function Declarations---------------
-void readMainSens();
-void readRevSens();
-void rptMainDirection();
-void rptRevDirection();
 void readAllSens();
+void syncSensor(byte index, unsigned long us);
+void applySensor(byte index, byte level, unsigned long us);
+void reportSensorHealth();
 //--end sensor functions---
 
+//---------------------Task Table--------------------------------
+//  Periods are in microseconds.  Sensors are sampled every millisecond,
+//  the state machine runs every 2ms and steps every yard once, so a
+//  sensor edge in any yard is acted on within about 3ms plus the longest
+//  task run, however busy the other yards are.  The knob is decoded by its ISR;
+//  the encoder task only picks up the turns every 10ms.  The display task
+//  may use the I2C bus for at most displayBudgetUs of every 2ms.
+//  Time from reset to the first sensor sample, the first state tick and
+//  the first full screen is kept and sent as TLM_READY.
+unsigned long bootSensorsUs = 0, bootControlUs = 0, bootDisplayUs = 0;
+unsigned long bootMark(byte milestone);
+void runStateMachine();
+void updateDisplay();
+void reportStats();
+void pollLink();
+void serviceProfile();
+const unsigned long displayBudgetUs = 1000;
+
+enum {TASK_SENSORS, TASK_ENCODER, TASK_STATE, TASK_DISPLAY, TASK_STATS, TASK_LINK,
+      TASK_JOURNAL, TASK_PROFILE, TASK_COUNT};
+Task tasks[] = {
+  TASK("sensors", readAllSens,     1000UL),
+  TASK("encoder", readEncoder,    10000UL),
+  TASK("state",   runStateMachine, 2000UL),
+  TASK("display", updateDisplay,   2000UL),
+  TASK("stats",   reportStats,  1000000UL),
+  TASK("link",    pollLink,        1000UL),
+  TASK("journal", pollJournal,     2000UL),
+  TASK("profile", serviceProfile,  2000UL),
+};
+Scheduler scheduler(tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+//---------------------SRAM Budget-------------------------------
+//  The Mega has 8KB of SRAM and nothing to say when it runs out but a
+//  corrupted stack.  Each part of the sketch's state has a share, and
+//  the shares, what the core and libraries take and a stack reserve
+//  must fit in the 8KB.  A struct or table that outgrows its share
+//  fails here, at compile time, on the board build only: sizes on the
+//  host are not the Mega's.  tools/memory_report.py checks the linked
+//  total and the headroom after every build.
+//
+//  A yard is about 58 bytes and a sensor pair about 26 (TrainGauge and
+//  EdgeCapture), so the yard share has room for two more yards.  The
+//  panel has no frame buffer (PanelRenderer.h): one 128 byte page in its
+//  share and one more on the stack while a page is compared.  The I/O
+//  share took some of what the frame buffer gave back: sensor health is
+//  13 bytes a detector and EdgeCapture keeps 4 more for its glitches.
+const unsigned int sramYardBytes    = 640;    //--yards, pairs, aligner, journal
+const unsigned int sramIoBytes      = 896;    //--edge capture, sensor health, motor link,
+                                              //  telemetry, knob
+const unsigned int sramDisplayBytes = 256;    //--renderer page buffer and page state
+const unsigned int sramTaskBytes    = 1024;   //--task table and histograms
+const unsigned int sramCoreBytes    = 700;    //--Serial, Serial1 (128 byte TX), Wire, core
+const unsigned int sramHeapBytes    = 0;      //--nothing is malloc()ed
+const unsigned int sramStackBytes   = 1536;   //--deepest call chain plus nested ISRs
+#if defined(__AVR__) && __SIZEOF_POINTER__ == 2
+static_assert(sizeof(Yard) <= 64, "a yard has outgrown 64 bytes");
+static_assert(sizeof(yards) + sizeof(pairBank) + sizeof(trainGauge) + sizeof(routeAligner) +
+              sizeof(journal) <= sramYardBytes, "yard state over its SRAM budget");
+static_assert(sizeof(edgeCapture) + sizeof(sensorHealth) + sizeof(motorLink) + sizeof(telemetry) +
+              sizeof(knob) <= sramIoBytes, "I/O state over its SRAM budget");
+static_assert(sizeof(panel) <= sramDisplayBytes,
+              "display state over its SRAM budget");
+static_assert(sizeof(tasks) + sizeof(scheduler) <= sramTaskBytes,
+              "task table over its SRAM budget");
+static_assert(sramYardBytes + sramIoBytes + sramDisplayBytes + sramTaskBytes + sramCoreBytes +
+              sramHeapBytes + sramStackBytes <= 8192, "SRAM budgets add up to more than 8KB");
+#endif
+
 
 //--------------------------------------------------------------//
 //                         void setup()                         //
@@ -182,23 +511,53 @@ void readAllSens();
 void setup() 
 {
   Serial.begin(115200);
-  tracknumLast = ROTARYMIN;
-  
-  
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) { // Address 0x3D for 128x64
-      Serial.println(F("SSD1306 allocation failed"));
-      for (;;); // Don't proceed, loop forever
-    }
+  telemetry.begin(Serial);
+
+  byte resetCause = 0;
+#if defined(__AVR__)
+  resetCause = MCUSR;
+  MCUSR = 0;
+#endif
+  tlmEvent(1, TLM_BOOT, 0, resetCause, 0, micros());
+  for (byte y = 0; y < YARD_COUNT; y++)
+  {
+    Yard &yd = yards[y];
+    yd.tracknumLast = yd.tracknumActive = yardInfo[y].firstTrack;
+    yd.railPower    = OFF;
+    yd.routePending = yd.powerPending = false;
+    yd.routeMoves   = 0;
+    yd.train.pair   = 0xFF;
+  }
   
   //---Setup the button (using external pull-up) :
-  pinMode(mainSensInpin, INPUT); pinMode(mainSensOutpin, INPUT);
-  pinMode(revSensInpin, INPUT);  pinMode(revSensOutpin, INPUT);
-
-  // After setting up the button, setup the Bounce instances :
-  debouncer1.attach(mainSensInpin); debouncer2.attach(mainSensOutpin);
-  debouncer3.attach(revSensInpin);  debouncer4.attach(revSensOutpin);
-  debouncer1.interval(5);           debouncer2.interval(5); // interval in ms
-  debouncer3.interval(5);           debouncer4.interval(5); 
+  for (byte i = 0; i < SENSOR_COUNT; i++)
+    if (sensorPin(i) != NO_PIN) pinMode(sensorPin(i), INPUT);
+
+  // After setting up the button, start interrupt capture and debounce :
+  pairBank.reset();
+  trainGauge.begin(pairSpacingMm, PAIR_COUNT);
+  edgeCapture.begin(capturePorts, sizeof(capturePorts) / sizeof(capturePorts[0]),
+                    SENSOR_COUNT, sensDebounceUs, sensDebounceMinUs, sensDebounceMaxUs);
+  sensorHealth.begin(SENSOR_COUNT, sensStuckMs);
+  healthCheckMs = millis();
+  if (TELEMETRY_LEVEL >= 4) edgeCapture.onRaw(tlmRawEdge);   //--trace recording
+  //---no throw hook: the driver throws the motors, the panel keeps the count
+  routeAligner.begin(0, tortiThrowMs, tortiSettleMs, tortiPerStep, tortiStaggerMs);
+  Serial1.begin(linkBaud);
+  motorLink.begin(Serial1, onDriverFrame, linkAckMs, MotorLink::bootSeq(linkBootAddr));
+
+  //---pick up where each yard was, and tell the driver the power it
+  //   should have, as it may have kept power through the reset
+  journal.begin(journalBase, journalBytes);
+  bool warm = false;
+  byte startState[YARD_COUNT];
+  for (byte y = 0; y < YARD_COUNT; y++)
+  {
+    startState[y] = HOUSEKEEP;
+    if (resumeYard(y, startState[y])) warm = true;
+    yards[y].powerPending = true;
+    sendPending(y);
+  }
 
 //DEBUG Section - these are manual switches until functions are ready
   //pinMode(mainPassByOff, INPUT_PULLUP);
@@ -207,26 +566,31 @@ void setup()
   pinMode(trackPowerLED_PIN, OUTPUT);
   //----END DEBUG---------------
 
-  encoder.setPosition(ROTARYMIN / ROTARYSTEPS); // start with the value of ROTARYMIN 
+  knob.begin(knobPinA, knobPinB);
 
   pinMode(rotarySwitch, INPUT_PULLUP);
   //mode = HOUSEKEEP;
 
-  digitalWrite(trackPowerLED_PIN, HIGH);
-  display.clearDisplay();
-  bandoText("B&O RAIL",25,0,2,false);
-  bandoText("JEROEN GARRITSEN'S",8,20,1,true);
-  bandoText("McKENZIE",0,33,2,true);
-  bandoText("DIVISION",30,50,2,true);
-  display.display();
-  delay(5000);
-  display.clearDisplay();
-  digitalWrite(trackPowerLED_PIN, LOW);
-  
-  
-  
+  //---the bus before any yard starts: a state may talk to the panel
+  Wire.begin();
+#if defined(__AVR__)
+  Wire.setWireTimeout(3000, true);     //--a bus with nothing on it must not hang
+#endif
 
-  
+  for (byte y = 0; y < YARD_COUNT; y++)
+    yards[y].machine.begin(yardTable, y, startState[y], tlmState);
+
+  //---the panel last: the splash goes out in slices from the display
+  //   task while the yards already run, and only after power up - a
+  //   brown-out or watchdog reset with a journal goes straight to work
+  startDisplay();
+  if (displayUp && (!warm || (resetCause & 0x01)))      //--PORF
+  {
+    drawScreen(SCREEN_SPLASH);
+    splashUntilMs = millis() + splashMs;
+    splashing = true;
+  }
+  scheduler.begin();
 }  //End setup
 
 //--------------------------------------------------------------//
@@ -235,351 +599,526 @@ void setup()
 
 void loop() 
 {
-      if(railPower == ON)  digitalWrite(trackPowerLED_PIN, HIGH);
-      else  digitalWrite(trackPowerLED_PIN, LOW);
+  scheduler.tick();
+}  //  END void loop
 
-      if (mode == HOUSEKEEP)
-  {
-      runHOUSEKEEP();
-  }
 
-  else if (mode == STAND_BY)
-  {
-      runSTAND_BY();
-  }
+//------------------------State Machine Task---------------------
+//  Steps every yard once, in turn.  A yard's reaction time is from the
+//  first transition of a sensor edge until its state tick has run with
+//  that edge in hand; the worst per yard goes out with the statistics.
+void runStateMachine()
+{
+  knobToggle = digitalRead(rotarySwitch);
+  bailOut = digitalRead(leaveTtimer);
+  knobPress = knobWas && !knobToggle;
+  knobWas = knobToggle;
 
-  else if (mode == TRACK_SETUP)
+  for (byte y = 0; y < YARD_COUNT; y++)
   {
-    runTRACK_SETUP();
+    Yard &yd = yards[y];
+    //--STAND_BY takes a press itself (EV_KNOB_PRESS); anywhere else it
+    //  queues the track the knob points at.  Both go by the one edge, so
+    //  a press as HOUSEKEEP hands over to STAND_BY is not taken twice.
+    if (knobPress && y == focusYard && yd.machine.state() != STAND_BY)
+      queueRoute(y, yd.tracknumChoice);
+    yd.machine.dispatch(pollEvents(y));
+    journal.commit(y, yardEntry(y));
+
+    if (yd.inputPending)
+    {
+      unsigned long react = micros() - yd.inputUs;
+      if (react > yd.worstReactUs) yd.worstReactUs = react;
+      yd.inputPending = false;
+    }
   }
 
-  else if (mode == TRACK_ACTIVE)
+      if(yards[focusYard].railPower == ON)  digitalWrite(trackPowerLED_PIN, HIGH);
+      else  digitalWrite(trackPowerLED_PIN, LOW);
+  if (!bootControlUs) bootControlUs = bootMark(BOOT_CONTROL);
+}
+
+//---micros() counts from the core's init(), just after the bootloader
+unsigned long bootMark(byte milestone)
+{
+  unsigned long us = micros();
+  if (us == 0) us = 1;                 //--0 is "not yet"
+  tlmReady(milestone, us);
+  return us;
+}
+  
+//------------------------Statistics Task-----------------------
+//  Once a second, at TELEMETRY_LEVEL 3, send each task's worst lateness
+//  and run time, each yard's worst reaction time and the capture/display
+//  counters as telemetry records.
+void reportStats()
+{
+  if (TELEMETRY_LEVEL < 3) return;
+
+  for (byte i = 0; i < TASK_COUNT; i++)
   {
-    runTRACK_ACTIVE();
+    tlmTask(i, 0, tasks[i].maxLateUs);
+    tlmTask(i, 1, tasks[i].maxRunUs);
   }
-
-  else if (mode == OCCUPIED)
+  for (byte y = 0; y < YARD_COUNT; y++)
   {
-    runOCCUPIED();
+    tlmReaction(y, yards[y].worstReactUs);
+    yards[y].worstReactUs = 0;
+    tlmRecovered(y, yards[y].holds, yards[y].recoveredMs);
   }
+  tlmCounter(0, edgeCapture.rawOverruns());
+  tlmCounter(1, edgeCapture.edgeOverruns());
+  tlmCounter(2, panel.bytesSent());
+  tlmCounter(3, panel.pagesSent());
+  tlmCounter(4, panel.pagesSkipped());
+  tlmCounter(5, telemetry.dropped());
+  tlmCounter(6, motorLink.resent());
+  tlmCounter(7, motorLink.badFrames());
+  tlmCounter(8, tasks[TASK_SENSORS].missed);
+  scheduler.resetStats();
+}
   
-  //----debug terminal print----------------
-      
-      //Serial.print("mainOutValue: ");
-      //Serial.print(mainOutValue);
-      //Serial.print("        revOutValue: ");
-      //Serial.println(revOutValue);
-      //Serial.print("mainSens_Report: ");
-      //Serial.print(mainSens_Report);
-      //Serial.print("     revSens_Report: ");
-      //Serial.println(revSens_Report);
-      Serial.print("mainSensTotal:      ");
-      Serial.print(mainSensTotal);
-      Serial.print("           revSensTotal:  ");
-      Serial.println(revSensTotal);
-      //Serial.print("mainPassByTotal: ");
-      //Serial.print(mainPassByTotal);
-      /////Serial.print("     revPassByTotal: ");
-      /////Serial.println(revPassByTotal); 
-      Serial.print("mainPassByState:    ");
-      Serial.print(mainPassByState);
-      Serial.print("          revPassByState: ");
-      Serial.println(revPassByState); 
-      //Serial.print("entryExitBusy: ");
-      //Serial.println(entry_ExitBusy); 
-      //Serial.print("mainDirection: ");
-      //Serial.print(mainDirection);  
-      //Serial.print("   revDirection: ");
-      //Serial.println(revDirection);  
-      Serial.print("main_LastDirection: ");
-      Serial.print(main_LastDirection);
-      Serial.print("       rev_lastDirection: ");
-      Serial.println(rev_LastDirection);
-      Serial.print("tracknumActive:    ");
-      Serial.print(tracknumActive);
-      Serial.print("           tracknumLast: ");
-      Serial.println(tracknumLast);
-      /*
-      Serial.println();
-      Serial.println("=======Report Starts Here!=======");
-      delay(307);
-      //---end debug printing   
-      */
-
-}  //  END void loop
- 
 // ---------------State Machine Functions Section----------------//
 //                          BEGINS HERE                          //
 //---------------------------------------------------------------//
 
+//---Everything one yard's transition table can react to, as of this
+//   tick.  The button and bail out switch only reach the focus yard.
+uint16_t pollEvents(byte y)
+{
+  Yard &yd = yards[y];
+  uint16_t events = _BV(EV_ALWAYS);
 
+  byte pairs = yardPairs(y);
 
-//--------------------HOUSEKEEP Function-----------------
-void runHOUSEKEEP()
-{
-  display.ssd1306_command(0xAF);  // turn OLED on
+  if(pairBank.busyMask() & pairs) events |= _BV(EV_SENSOR_BUSY);
+  else events |= _BV(EV_SENSORS_CLEAR);
 
-  Serial.println();
-  Serial.println("-----------------------------------------HOUSEKEEP---");
+  if(y == focusYard && knobPress) events |= _BV(EV_KNOB_PRESS);
+  if(y == focusYard && bailOut == 0) events |= _BV(EV_BAIL_OUT);
 
-  if(tracknumLast < ROTARYMAX) railPower = OFF;
-  if(railPower == ON)  digitalWrite(trackPowerLED_PIN, HIGH);
-  else  digitalWrite(trackPowerLED_PIN, LOW);
-  
-  //Serial.print("railPower Status: ");
-  //Serial.println(railPower);
-
-  tracknumChoice = tracknumLast;
-
-    enum {BufSize=3};  
-    char buf[BufSize];
-    snprintf (buf, BufSize, "%2d", tracknumLast);
-    display.clearDisplay();
-    bandoText("SELECT NOW",0,0,2,false);
-    bandoText("TRACK",0,20,2,false);
-    if(tracknumLast == ROTARYMAX) bandoText("RevL",70,20,2,false);
-    else bandoText(buf,80,20,2,false);
-    bandoText("PUSH BUTTON TO SELECT",0,46,1,false);
-    bandoText("TRACK POWER  -HK-",0,56,1,true);
+  if(yd.queued) events |= _BV(EV_ROUTE_QUEUED);
+  if(yd.routeSet) events |= _BV(EV_ROUTE_SET);
 
-  
-  //Serial.println(tracknumActive);
-  //delay(1000);
-  mode = STAND_BY;
-}  
-
-//-----------------------STAND_BY Function-----------------
-void runSTAND_BY()
-{
-    
-    
-  Serial.println("-----------------------------------------STAND_BY---");
-  do
+  if(yd.machine.state() == TRACK_ACTIVE) fitHold(y);
+  if(yd.machine.timedOut())
   {
-    readEncoder();
-   
-    knobToggle = digitalRead(rotarySwitch);
-    
-    readAllSens();
-
-    if((mainSens_Report > 0) || (revSens_Report > 0))
+    events |= _BV(EV_TIMEOUT);
+    if(yd.machine.state() == TRACK_SETUP && !yd.routeSet)
     {
-      Serial.println("---to OCCUPIED from STAND_BY---");
-      
-      //display.clearDisplay();
-      //bandoText("YARD LEAD",0,0,2,false);
-      //bandoText("OCCUPIED",0,20,2,true);
-
-      //mode = OCCUPIED;
-      runOCCUPIED();
+      tlmFault(FAULT_LINK);
+      routeAligner.restore(y, 0, 0);   //--where the turnouts are is not known now
     }
   }
-  while (knobToggle == true);    //check rotary switch pressed to select a track (active low)
 
-  knobToggle = true;          //---reset so readEncoder will run in stand_by 
-  
-  mode = TRACK_SETUP;
-} 
+        //--true when outbound train completely leaves sensor  
+  if(pairBank.passByMask() & pairBank.lastOutboundMask() & pairs) events |= _BV(EV_TRAIN_GONE);
+
+  return events;
+}
 
+//---Print the transition table, for checking it against the flow chart
+void dumpStates(Print &out)
+{
+  StateMachine::dump(out, yardTable, yardStateNames, yardEventNames, yardActionNames);
+}
+
+//---the reverse loop is shown by name, not number
+bool namedTrack(byte y, byte track)
+{
+  return yardInfo[y].revLoop && track == yardInfo[y].lastTrack;
+}
+
+//--------------------HOUSEKEEP Function-----------------
+void enterHOUSEKEEP(byte y)
+{
+  Yard &yd = yards[y];
+  if (displayUp) panel.command(0xAF);  // turn OLED on
+
+  if(!namedTrack(y, yd.tracknumLast)) setRailPower(y, OFF);
+
+  yd.tracknumChoice = yd.tracknumLast;
+  requestScreen(y, SCREEN_HOUSEKEEP);
+}     
 
 //-----------------------TRACK_SETUP- State Function-----------------------
-void runTRACK_SETUP()
+//  Sends the driver one ROUTE with the turnouts of the route that are not
+//  already set for it; the driver cuts the yard's rail power and throws
+//  them.  Rail power comes back on (railPowerOn()) when the driver reports
+//  them home, or linkMarginMs after they should have been if it does not;
+//  then the yard's turnouts are taken as unknown and the next route
+//  throws them all.
+void enterTRACK_SETUP(byte y)
 {
-  readAllSens();
-  
-  railPower = OFF;
-  if(railPower == ON)  digitalWrite(trackPowerLED_PIN, HIGH);
-  else  digitalWrite(trackPowerLED_PIN, LOW);
-
-  Serial.println("-----------------------------------------TRACK_SETUP---");
-  tracknumActive = tracknumChoice;  
-  tracknumLast = tracknumActive;
-
-  display.clearDisplay();
-  enum {BufSize=3};  
-  char buf[BufSize];
-  snprintf (buf, BufSize, "%2d", tracknumActive);
-  display.clearDisplay();
-  bandoText("ALIGNING",0,0,2,false);
-  bandoText("TRACK",0,20,2,false);
-  if(tracknumActive == ROTARYMAX) bandoText("RevL",70,20,2,false);
-  else bandoText(buf,80,20,2,false);
-  bandoText("HAVE A NICE DAY",0,46,1,false);
-  bandoText("TRACK POWER  -OFF-",0,56,1,true);
-  
+  Yard &yd = yards[y];
+  yd.railPower = OFF;
 
-  
-  
-  unsigned long startTortiTime = millis();
-  while((millis() - startTortiTime) <= tortiTimerInterval)
+  yd.tracknumActive = yd.tracknumChoice;
+  yd.tracknumLast = yd.tracknumActive;
+  tlmTrack(y, yd.tracknumActive);
+
+  Route r;
+  if (trackRoute(y, yd.tracknumActive, r))
   {
-   readAllSens();
+    unsigned long offMs = routeAligner.align(y, r);
+    if (++yd.routeTag == 0) yd.routeTag = 1;   //--0 is a driver just started
+    yd.routeMoves  |= routeAligner.moves(y);
+    yd.routePending = true;
+    yd.routeSet     = false;
+    sendPending(y);
+    yd.machine.setTimeout(offMs + linkMarginMs);
+    tlmAlign(y, routeAligner.moved(y), offMs);
   }
-  railPower = ON;
-  if(railPower == ON)  digitalWrite(trackPowerLED_PIN, HIGH);
-  else  digitalWrite(trackPowerLED_PIN, LOW);
-  leaveTrack_Setup();
-  
-}  //---end track setup function-------------------
+  requestScreen(y, SCREEN_ALIGNING);
+}
+
+bool trackRoute(byte y, byte track, Route &r)
+{
+  if (y >= YARD_COUNT || track < yardInfo[y].firstTrack || track > yardInfo[y].lastTrack)
+    return false;
+  memcpy_P(&r, &yardRoutes[y][track - yardInfo[y].firstTrack], sizeof(r));
+  return true;
+}
 
+//------------------------Profile Task--------------------------------
+//  A 'P' from the host dumps the scheduler's histograms as TLM_HIST
+//  records, one a run and only while the port has room for two, so the
+//  dump never crowds out the yards' own telemetry.  Empty buckets are
+//  skipped.  The histograms start again once the dump is out.
+int  dumpTask = -1;                    //--TASK_COUNT: the loop pass; -1 idle
+byte dumpKind, dumpSlot;
 
-void leaveTrack_Setup()
+void serviceProfile()
 {
-  Serial.println("---Entering leaveTrack_Setup---");
-  readAllSens();
- 
-  if((mainSens_Report > 0) || (revSens_Report > 0))
-  {
-    Serial.println("---to OCCUPIED from leaveTrack_Setup---");
-    mode = OCCUPIED;
-  }
-  else 
+  while (Serial.available() > 0)
+    if (Serial.read() == 'P' && dumpTask < 0)
+    {
+      dumpTask = 0;
+      dumpKind = HIST_RUN;
+      dumpSlot = 0;
+    }
+  if (dumpTask < 0 || !telemetry.room(2)) return;
+
+  while (dumpTask <= TASK_COUNT)
   {
-    Serial.println("--times up--leaving TrackSetup--");
-    mode = TRACK_ACTIVE;
+    bool pass = dumpTask == TASK_COUNT;
+    const Histogram &h = pass ? scheduler.loopHist() :
+                         dumpKind == HIST_RUN ? tasks[dumpTask].runHist : tasks[dumpTask].lateHist;
+    byte id   = pass ? (byte)HIST_LOOP_ID : (byte)dumpTask;
+    byte kind = pass ? (byte)HIST_LOOP : dumpKind;
+    byte slot = dumpSlot++;
+    bool any  = h.maxUs >= h.minUs;    //--anything since clearProfile()
+    unsigned long value;
+    if (slot < Histogram::BUCKETS) value = h.count[slot];
+    else if (slot == HIST_MIN) value = any ? h.minUs : 0;
+    else if (slot == HIST_MAX) value = h.maxUs;
+    else value = !pass && kind == HIST_RUN ? tasks[dumpTask].missed : 0;
+    bool send = value || (any && (slot == HIST_MIN || slot == HIST_MAX));
+
+    if (slot == HIST_MISSED)           //--on to the next histogram
+    {
+      dumpSlot = 0;
+      if (pass || dumpKind == HIST_LATE)
+      {
+        dumpTask++;
+        dumpKind = HIST_RUN;
+      }
+      else dumpKind = HIST_LATE;
+    }
+    if (send)
+    {
+      tlmHist(id, kind, slot, value);
+      return;
+    }
   }
+  tlmHist(HIST_END, 0, 0, 0);
+  scheduler.clearProfile();
+  dumpTask = -1;
 }
 
+//------------------------Warm Start Journal--------------------------
+//  Each yard's entry is offered to the journal every state tick and only
+//  written when it has changed; the journal task writes it a byte at a
+//  time as the EEPROM is ready.
+JournalEntry yardEntry(byte y)
+{
+  Yard &yd = yards[y];
+  JournalEntry e = { yd.tracknumLast, routeAligner.position(y), routeAligner.known(y),
+                     (byte)((yd.railPower == ON ? JOURNAL_POWER : 0) |
+                            (yd.machine.state() == OCCUPIED ? JOURNAL_OCCUPIED : 0)) };
+  return e;
+}
 
-//-----------------------TRACK_ACTIVE State Function------------------
-void runTRACK_ACTIVE()
-{
-  readAllSens();
-    display.clearDisplay();
-    bandoText("PROCEED ",20,0,2,false);
-    bandoText("TIMER ON",0,20,2,false);
-    //bandoText("3 MINUTE TIMER -ON-",0,46,1,false);
-    bandoText("TRACK POWER  -ON-",0,56,1,true);
-
-  Serial.println("-----------------------------------------TRACK_ACTIVE---");
-  rev_LastDirection = 0; //reset for use during the next TRACK_ACTIVE call
-  main_LastDirection = 0;
- 
-  unsigned long startTrainTime = millis();
-  do
+void pollJournal()
+{
+  journal.service();
+}
+
+//---from the journal at boot.  A yard that was OCCUPIED keeps its rail
+//   power and starts OCCUPIED; anything else starts in HOUSEKEEP with
+//   the power HOUSEKEEP would leave it.
+bool resumeYard(byte y, byte &startState)
+{
+  JournalEntry e;
+  if (!journal.recall(y, e) || e.track < yardInfo[y].firstTrack ||
+      e.track > yardInfo[y].lastTrack) return false;
+
+  Yard &yd = yards[y];
+  yd.tracknumLast = yd.tracknumActive = yd.tracknumChoice = e.track;
+  routeAligner.restore(y, e.position, e.known);
+  bool occupied = e.flags & JOURNAL_OCCUPIED;
+  yd.railPower = (e.flags & JOURNAL_POWER) && (occupied || namedTrack(y, e.track)) ? ON : OFF;
+  if (occupied) startState = OCCUPIED;
+  tlmResume(y, e.track, e.flags);
+  return true;
+}
+
+//------------------------Motor Driver Link Task----------------------
+//  Takes in the driver's STATUS frames and keeps the link moving.  A
+//  STATUS for a yard's last ROUTE without STATUS_MOVING is the route home.
+//  A ROUTE or POWER that found the link queue full goes out from here.
+//
+//  A settled STATUS must show the yard as the panel has it.  A driver
+//  that has reset comes back with every yard off, its motor outputs
+//  normal and tag 0, which no ROUTE of ours carries, so tag 0 is always
+//  checked.  Any other STATUS is checked only with nothing of ours on the
+//  link or waiting, and its turnouts only on our last tag, as an older
+//  STATUS may still be on its way.  A mismatch sends the power again,
+//  and the route for turnouts that are not where we sent them.
+void pollLink()
+{
+  motorLink.poll();
+  for (byte y = 0; y < YARD_COUNT; y++) sendPending(y);
+}
+
+void onDriverFrame(byte type, const byte *payload, byte len)
+{
+  if (type != LINK_STATUS || len < sizeof(DriverStatus)) return;
+  DriverStatus s;
+  memcpy(&s, payload, sizeof(s));
+  if (s.yard >= YARD_COUNT) return;
+
+  Yard &yd = yards[s.yard];
+  if (s.flags & STATUS_MOVING) return;
+  if (s.tag == yd.routeTag) yd.routeSet = true;
+  if (s.tag != 0 && (!motorLink.idle() || yd.routePending || yd.powerPending)) return;
+
+  byte stray = 0;
+  if (s.tag == yd.routeTag || s.tag == 0)
+    stray = (s.position ^ routeAligner.position(s.yard)) & routeAligner.known(s.yard);
+  bool powered = s.flags & STATUS_POWER;
+  if (!stray && powered == (yd.railPower == ON)) return;
+
+  tlmFault(FAULT_DRIVER);
+  if (stray)
   {
-     readAllSens();
-     bailOut = digitalRead(leaveTtimer);
-     //---debug     
-     Serial.print("main_LastDirection: ");
-     Serial.print(rev_LastDirection);
-     Serial.println(main_LastDirection);
-     Serial.println("-----Waiting for Train to Exit!");
-     //debug
-     
-        //--true when outbound train completely leaves sensor  
-    if (((mainPassByState == 1) && (main_LastDirection == 2)) ||
-         ((rev_LastDirection == 2) && (revPassByState == 1)))           
-    {
-      
-      break;
-      //startTrainTime = startTrainTime + trainTimerInterval;  //adds time to startTrainTime to force end of while loop
-    }
+    yd.routeMoves  |= stray;
+    yd.routePending = true;
 
-    if(bailOut == 0)
+    //--a route being set up waits for these throws, as it did for its own
+    if (yd.machine.state() == TRACK_SETUP)
     {
-      break;
-      //startTrainTime = startTrainTime + trainTimerInterval;
+      byte n = 0;
+      for (byte b = yd.routeMoves; b; b &= b - 1) n++;
+      yd.machine.setTimeout(yd.machine.elapsedMs() + routeAligner.throwTimeMs(n) +
+                            linkMarginMs);
     }
-    
   }
-  while (millis() - startTrainTime <= trainTimerInterval);
-  mainPassByState = false;
-  revPassByState = false;
+  yd.powerPending = true;              //--a ROUTE leaves the power off
+  sendPending(s.yard);
+}
 
-  leaveTrack_Active();
- 
-}  //--end runTrack_Active---
+void railPowerOn(byte y)
+{
+  setRailPower(y, ON);
+}
 
+//---the yard's track power, on the driver
+void setRailPower(byte y, byte level)
+{
+  Yard &yd = yards[y];
+  if (yd.railPower == level) return;
+  yd.railPower    = level;
+  yd.powerPending = true;
+  sendPending(y);
+}
 
-void leaveTrack_Active()
+//---Queue the yard's pending ROUTE, then its POWER, as the link has room.
+//   The ROUTE always goes first: the driver cuts power for it and keeps
+//   it off until the POWER after it.  Each carries the yard as it is when
+//   it goes, so a ROUTE still waiting when the next is set up throws the
+//   turnouts of both, and only the last power level is sent.
+void sendPending(byte y)
 {
-  readAllSens();
-  if((mainSens_Report > 0) || (revSens_Report > 0))
+  Yard &yd = yards[y];
+  if (yd.routePending)
   {
-    Serial.println("----to OCCUPIED from leavTrack_Active---");
-    mode = OCCUPIED;
+    RouteCommand c = { y, yd.routeTag, yd.routeMoves, routeAligner.position(y) };
+    if (!motorLink.send(LINK_ROUTE, &c, sizeof(c))) return;
+    yd.routePending = false;
+    yd.routeMoves   = 0;
   }
-  else 
+  if (yd.powerPending)
   {
-    Serial.println("--times up leaving TrackActive--");
-    mode = HOUSEKEEP;
+    byte p[2] = { y, yd.railPower == ON };
+    if (!motorLink.send(LINK_POWER, p, sizeof(p))) return;
+    yd.powerPending = false;
   }
 }
 
-//-------------------------OCCUPIED State Function--------------------
-void runOCCUPIED()
+
+//-----------------------TRACK_ACTIVE State Function------------------
+//  Held until the hold runs out, an outbound train has completely
+//  passed a sensor pair, or the bail out switch is hit.  The hold starts
+//  at trainTimerInterval and is fitted to the train as it moves:
+//
+//   - while a train is on the yard's sensors and they have edged in the
+//     last holdMovingMs, it is still moving, and the hold is kept at
+//     least holdMovingMs ahead.  A train that sits on the sensors stops
+//     the edges, the hold runs out and the yard goes OCCUPIED.
+//   - once an arriving train has gone in through the main pair, its
+//     tail is at the pair; at the measured speed it needs
+//     trackDistanceMm() more to clear the track's turnout, plus a
+//     quarter for braking and holdSettleMs to stand.  The hold becomes
+//     just that, which is usually well short of trainTimerInterval.
+//
+//  Never more than holdMaxMs.  Each release sends how long the track was
+//  held; the yard keeps what the shorter ones recovered against
+//  trainTimerInterval.
+void enterTRACK_ACTIVE(byte y)
 {
-  Serial.println("OCCUPIED");
+  requestScreen(y, SCREEN_PROCEED);
 
-  display.clearDisplay();
-  
-  //bandoText("PUSH BUTTON TO SELECT",0,46,1,false);
-  //bandoText("TRACK POWER  -ON-",0,56,1,true);
-    
-  while((mainSens_Report > 0) || (revSens_Report > 0))
-  {
-    
-    readAllSens();
-    Serial.println("----to OCCUPIED from OCCUPIED---");
-    bandoText("YARD LEAD",0,0,2,false);
-    bandoText("OCCUPIED",0,20,2,false);
-    bandoText("STOP!",20,42,2,true);
-    //mode = OCCUPIED;
-  }
-   
-  Serial.println("----Leaving OCCUPIED---");
-  runHOUSEKEEP();
+  pairBank.clearLastDirection(yardPairs(y)); //reset for use during the next TRACK_ACTIVE call
+  yards[y].holdFitted = false;
+}
+
+unsigned long trackDistanceMm(byte y, byte track)
+{
+  const YardInfo &yi = yardInfo[y];
+  return yi.leadMm + (unsigned long)yi.ladderMm * (track - yi.firstTrack);
+}
+
+//---from the tail passing the main pair until the train stands in the track;
+//   without a speed, the unfitted hold
+unsigned long clearanceMs(byte y, byte track, uint16_t speedMmS)
+{
+  if (speedMmS == 0) return (unsigned long)trainTimerInterval;
+  return trackDistanceMm(y, track) * 1250UL / speedMmS + holdSettleMs;
+}
+
+void fitHold(byte y)
+{
+  Yard &yd = yards[y];
+  unsigned long now  = yd.machine.elapsedMs();
+  unsigned long hold = yd.machine.timeout();
+
+  if ((pairBank.busyMask() & yardPairs(y)) && millis() - yd.lastEdgeMs < holdMovingMs &&
+      hold < now + holdMovingMs)
+    hold = now + holdMovingMs;
+  if (hold > holdMaxMs) hold = holdMaxMs;
+  yd.machine.setTimeout(hold);
+}
+
+//---an arrival through the main pair: hold until it is in.  One with no
+//   measured speed keeps the hold it has, trainTimerInterval.
+void trainMeasured(byte y, const TrainMeasure &m)
+{
+  Yard &yd = yards[y];
+  if (yd.machine.state() != TRACK_ACTIVE || m.pair != y * 2 + PAIR_MAIN ||
+      m.direction != INBOUND || m.speedMmS == 0) return;
+
+  unsigned long hold = yd.machine.elapsedMs() +
+                       clearanceMs(y, yd.tracknumActive, m.speedMmS);
+  yd.machine.setTimeout(hold < holdMaxMs ? hold : holdMaxMs);
+  yd.holdFitted = true;
+}
+
+void releaseTrack(byte y)
+{
+  Yard &yd = yards[y];
+  unsigned long held = yd.machine.elapsedMs();
+
+  pairBank.clearPassBy(yardPairs(y));
+  yd.holds++;
+  //--a hold kept past trainTimerInterval recovers nothing; TLM_HOLD has it
+  if (held < (unsigned long)trainTimerInterval) yd.recoveredMs += trainTimerInterval - held;
+  tlmHold(y, yd.holdFitted, held);
+}
+
+//---the bail out switch also drops whatever was queued behind the route
+void bailOutTrack(byte y)
+{
+  releaseTrack(y);
+  if (yards[y].queued) tlmQueue(y, 0, 0);
+  yards[y].queued = 0;
+}
+
+//--------------------------Route Queue-------------------------------
+//  Presses while the yard is busy line up the next routes; HOUSEKEEP, or
+//  STAND_BY once the lead is clear, hands the oldest to TRACK_SETUP
+//  through tracknumChoice, just as a press in STAND_BY would.  A full
+//  queue ignores the press.
+void queueRoute(byte y, byte track)
+{
+  Yard &yd = yards[y];
+  if (yd.queued >= ROUTE_QUEUE) return;
+  yd.queue[yd.queued++] = track;
+  tlmQueue(y, track, yd.queued);
+}
+
+void nextRoute(byte y)
+{
+  Yard &yd = yards[y];
+  yd.tracknumChoice = yd.queue[0];
+  yd.queued--;
+  memmove(yd.queue, yd.queue + 1, yd.queued);
+}
+
+//-------------------------OCCUPIED State Function--------------------
+//  Shows the warning until both sensor pairs report clear.
+void enterOCCUPIED(byte y)
+{
+  requestScreen(y, SCREEN_OCCUPIED);
 }
 
 //------------------------ReadEncoder Function----------------------
+//  Picks up whatever the knob ISR has counted since the last run, so a
+//  quick spin is one change to the latest track, not a redraw per step.
+//  The knob runs through the tracks of yard 1, then yard 2 and so on.
+//  Pointing into a yard in STAND_BY shows SELECT for it; pointing into
+//  a busy yard shows what that yard is doing.
 
 void readEncoder()
 {
-  /*if((millis() - startDisplayTime) >= (displayTimerInterval))  //display off
-    {
-      display.ssd1306_command(0xAE);   //turn OLED off  and see line 320
-      startDisplayTime = (displayTimerInterval + millis());
-    }
-  */
-  encoder.tick();
-  // get the current physical position and calc the logical position
-  int newPos = encoder.getPosition() * ROTARYSTEPS;
-
-  if (newPos < ROTARYMIN) {
-    encoder.setPosition(ROTARYMIN / ROTARYSTEPS);
-    newPos = ROTARYMIN;
-  } 
-  else if (newPos > ROTARYMAX) {
-    encoder.setPosition(ROTARYMAX / ROTARYSTEPS);
-    newPos = ROTARYMAX;
-  } 
-
-  if (lastPos != newPos) 
+  int turned = knob.take();
+  if(turned == 0) return;
+
+  //---position over all yards' tracks, then back to (yard, track)
+  int pos = 0;
+  for (byte y = 0; y < focusYard; y++)
+    pos += yardInfo[y].lastTrack - yardInfo[y].firstTrack + 1;
+  pos += yards[focusYard].tracknumChoice - yardInfo[focusYard].firstTrack;
+  pos += turned * ROTARYSTEPS;
+  if (pos < 0) pos = 0;
+
+  byte y = 0;
+  while (y < YARD_COUNT - 1 && pos > yardInfo[y].lastTrack - yardInfo[y].firstTrack)
   {
-    Serial.print(newPos);
-    Serial.println();
-
-    display.ssd1306_command(0xAF);  // turn OLED on
-    display.clearDisplay();
-
-    //startDisplayTime = millis();  //display off
-
-    delay(20);
-
-    lastPos = newPos;
-    tracknumChoice = newPos;
-      
-    enum {BufSize=3};  
-    char buf[BufSize];
-    snprintf (buf, BufSize, "%2d", tracknumChoice);
-    display.clearDisplay();
-    bandoText("SELECT NOW",0,0,2,false);
-    bandoText("TRACK",0,20,2,false);
-    if(tracknumChoice == ROTARYMAX) bandoText("RevL",70,20,2,false);
-    else bandoText(buf,80,20,2,false);
-    bandoText("PUSH BUTTON TO SELECT",0,46,1,false);
-    bandoText("TRACK POWER  -OFF-",0,56,1,true);
+    pos -= yardInfo[y].lastTrack - yardInfo[y].firstTrack + 1;
+    y++;
+  }
+  int newPos = yardInfo[y].firstTrack + pos;
+  if (newPos > yardInfo[y].lastTrack) newPos = yardInfo[y].lastTrack;
+
+  if (y != focusYard || newPos != yards[y].tracknumChoice) 
+  {
+    focusYard = y;
+    yards[y].tracknumChoice = newPos;
+    tlmSelect(y, newPos);
+    if (yards[y].machine.state() == STAND_BY)
+      requestScreen(y, SCREEN_SELECT);   //--display task coalesces quick spins
+    else screenPending = (Screen)yards[y].screen;
   }
 }     
 
@@ -588,162 +1127,214 @@ void readEncoder()
 
 //---------------------Updating Sensor Functions------------------
 //  All in this section update and track sensor information: Busy,
-//  Direction, PassBy.  Only the mainOut sensor is documented.  
-//  The remaining three work identically.
+//  Direction, PassBy.  Every pair of every yard - main and rev - is a
+//  bit of pairBank, and one PairBank::update() advances them all with
+//  the logic of PairState::update() (src/SensorPair.cpp).  The levels
+//  are the debounced ones as of the edge being processed.
 //------------------------------end of note-----------------------
-
-void readMainSens() {
-  debouncer1.update();  
-  int mainInValue = debouncer1.read();
-    
-  if(mainInValue != mainIn_LastValue)     
+  
+//---Sensor task: feed each debounced edge through the pair logic one at a
+//   time, in the order they happened, so two edges that land in the same
+//   tick are still counted in the right order.  Sensor 2n is pair n's In,
+//   2n + 1 its Out, and an edge only changes the pair it belongs to.  A
+//   sensor the health monitor has masked reads clear to its pair; once a
+//   second the monitor judges every sensor.  Edges that overfilled the
+//   ring never come through, so then every pair is synced to read().
+void readAllSens() 
+  {
+    SensorEdge e;
+    if (!bootSensorsUs) bootSensorsUs = bootMark(BOOT_SENSORS);
+    edgeCapture.update();
+    while (edgeCapture.nextEdge(e))
     {
-      if(mainInValue == 0) bitSet(mainSens_Report, 0);
-      else bitClear(mainSens_Report, 0); 
-
-      mainIn_LastValue = mainInValue;
-
-      if (mainSens_Report > 0) 
-      {
-        mainSensTotal = mainSensTotal + mainSens_Report;
-        mainPassByTotal = mainSensTotal;
-      }
-      else mainSensTotal = 0;   
+      if (sensorHealth.edge(e.index, e.level, millis()))
+        tlmHealth(e.index, sensorHealth.condition(e.index));
+      syncSensor(e.index, e.us);
     }
-    
-  debouncer2.update();  //read mainOut sensor
-  int mainOutValue = debouncer2.read();
-
-      //---update history register:*Sens_Report    
-  if(mainOutValue != mainOut_LastValue)   
+    if (edgeCapture.edgeOverruns() != edgeLostSeen)
     {
-      if(mainOutValue == 0) bitSet(mainSens_Report, 1);
-      else bitClear(mainSens_Report, 1); 
-
-      mainOut_LastValue = mainOutValue;
-
-      //---add running total to "*"SensTotal to track PassBy status
-      if (mainSens_Report > 0) 
-      {
-        mainSensTotal = mainSensTotal + mainSens_Report;
-        mainPassByTotal = mainSensTotal;
-      }
-      else mainSensTotal = 0; 
+      edgeLostSeen = edgeCapture.edgeOverruns();
+      for (byte i = 0; i < SENSOR_COUNT; i++) syncSensor(i, micros());
     }
-    //---PassByTotal of "6" means train has cleared the sensor success-
-    //  fully.  If train were to back out of sensors the sensors would
-    //  fire and up the count, the condition would not ever be met.
-    //---------end of note------  
 
-    if(mainSensTotal == 0 && mainPassByTotal == 6) 
+    if (millis() - healthCheckMs >= 1000)
+    {
+      healthCheckMs += 1000;
+      uint16_t changed = sensorHealth.check(millis());
+      for (byte i = 0; changed; i++, changed >>= 1)
       {
-       mainPassByState = true;
-       mainPassByTotal = 0;
+        if (!(changed & 1)) continue;
+        tlmHealth(i, sensorHealth.condition(i));
+        syncSensor(i, micros());
       }
-    else if(mainSensTotal == 0) mainPassByTotal = 0;
-
-    //--report mainLine Direction
-    if((mainSensTotal == 2) && (mainSens_Report == 2)) 
-    { 
-      mainDirection = 2;
-      main_LastDirection = 2;
+      reportSensorHealth();
     }
-    else if((mainSensTotal == 1) && (mainSens_Report == 1)) 
-    {
-      mainDirection = 1;
-      main_LastDirection = 1;
-    }
-    if((mainSensTotal == 0) && (mainSens_Report == 0)) 
-    {
-     mainDirection = 0;
-    } 
-    
-}  // end readMainSen--
-
-void readRevSens() 
-{ 
-  //byte revPassByTotal = 0;
-  //byte revDirection = 0;
-
-  debouncer3.update();
-  int revInValue = debouncer3.read();
-    
-  if(revInValue != revIn_LastValue)     
-  {
-    if(revInValue == 0) bitSet(revSens_Report, 0);
-    else bitClear(revSens_Report, 0); 
-
-    revIn_LastValue = revInValue;
-
-     if (revSens_Report > 0) 
-    {
-      revSensTotal = revSensTotal + revSens_Report;
-      revPassByTotal = revSensTotal;
-    }
-    else revSensTotal = 0;   
   }
-      
-  debouncer4.update();
-  int revOutValue = debouncer4.read();
-    
-  if(revOutValue != revOut_LastValue)     
-  {
-    if(revOutValue == 0) bitSet(revSens_Report, 1);
-    else bitClear(revSens_Report, 1); 
 
-    revOut_LastValue = revOutValue;
+//---Bring the pair's view of one sensor in line with the sensor: its
+//   debounced level, or clear while it is masked
+void syncSensor(byte index, unsigned long us)
+{
+  byte level = sensorHealth.masked(index) ? HIGH : edgeCapture.read(index);
+  byte was   = (pairLevels[index & 1] >> (index >> 1)) & 1;
+  if (level != was) applySensor(index, level, us);
+}
 
-    if (revSens_Report > 0) 
-    {
-      revSensTotal = revSensTotal + revSens_Report;
-      revPassByTotal = revSensTotal;
-    }
-    else revSensTotal = 0; 
-  }
-    if(revSensTotal == 0 && revPassByTotal == 6) 
+//---One sensor level change through the pair logic, with the telemetry,
+//   train gauge and reaction timing that go with it
+void applySensor(byte index, byte level, unsigned long us)
+  {
+    byte id     = index >> 1;
+    byte lane   = _BV(id);
+    Yard &yd    = yards[index / SENSORS_PER_YARD];
+    byte dirWas = pairBank.direction(id), passWas = pairBank.passByMask();
+
+    tlmEdge(index, level, us);
+    trainGauge.edge(index, level, us);
+    if (level) pairLevels[index & 1] |= lane;
+    else pairLevels[index & 1] &= ~lane;
+    pairBank.update(pairLevels[0], pairLevels[1]);
+
+    //---report changes, stamped with the edge that caused them
+    if (pairBank.direction(id) != dirWas)
+      tlmDirection(id, pairBank.direction(id), us);
+    if (pairBank.passByMask() & ~passWas & lane)
     {
-      revPassByState = true;
-      revPassByTotal = 0;
-    }
-    else if(revSensTotal == 0) revPassByTotal = 0;
+      tlmPassBy(id, pairBank.lastDirection(id), us);
 
-    //--report revLoop Direction
-    if((revSensTotal == 2) && (revSens_Report == 2)) 
-    {
-      revDirection = 2;
-      rev_LastDirection = 2;
-    }
-    else if((revSensTotal == 1) && (revSens_Report == 1)) 
-    {
-      revDirection = 1;
-      rev_LastDirection = 1;
+      //---speed and length of the train that just went through
+      TrainMeasure m;
+      if (trainGauge.measure(id, pairBank.lastDirection(id), m))
+      {
+        yd.train = m;
+        tlmTrain(id, 0, m.speedMmS, m.us);
+        tlmTrain(id, 1, m.lengthMm, m.us);
+        trainMeasured(index / SENSORS_PER_YARD, m);
+      }
     }
-    if((revSensTotal == 0) && (revSens_Report == 0)) 
+
+    yd.lastEdgeMs = millis();
+    if (!yd.inputPending)
     {
-      revDirection = 0;
+      yd.inputPending = true;
+      yd.inputUs      = us;
     }
+  }
 
-}  // end readrevSen--
-
-  
-void readAllSens() 
+//---At TELEMETRY_LEVEL 3, each sensor's health figures in turn: four
+//   sensors a second, fewer if the serial buffer has no room
+void reportSensorHealth()
+{
+  if (TELEMETRY_LEVEL < 3) return;
+  for (byte n = 0; n < 4 && telemetry.room(5); n++)
   {
-    readMainSens();
-    readRevSens();
-  }   
+    byte i = healthNext;
+    healthNext = (healthNext + 1) % SENSOR_COUNT;
+    tlmHealthStat(i, HEALTH_EDGES, sensorHealth.edges(i));
+    tlmHealthStat(i, HEALTH_BUSIEST, sensorHealth.busiestSecond(i));
+    tlmHealthStat(i, HEALTH_BLOCKED, sensorHealth.longestBlocked(i));
+    tlmHealthStat(i, HEALTH_GLITCHES, edgeCapture.glitches(i));
+    tlmHealthStat(i, HEALTH_WINDOW, edgeCapture.window(i));
+  }
+}
 
 // ------------------Display Functions Section-------------------//
 //                          BEGINS HERE                          //
 //---------------------------------------------------------------//
 
-void bandoText(String text, int x, int y, int size, boolean d){
-  display.setTextSize(size);
-  display.setTextColor(WHITE);
-  display.setCursor(x,y);
-  display.println(text);
-  if(d){
-    display.display();
+//---A yard asks for a screen.  The panel only shows it if the yard has
+//   the focus; only the latest request is kept, so several requests
+//   between display ticks cost one redraw.
+void requestScreen(byte y, Screen s)
+{
+  yards[y].screen = s;
+  if (y == focusYard) screenPending = s;
+}
+
+//--------------------Display Task-------------------
+//  Takes up a requested screen, then sends at most displayBudgetUs of
+//  its changed pages to the panel.  A full screen change goes out
+//  over a few dozen ticks while the other tasks keep running.  Screens
+//  asked for during the splash wait for it to end.
+void updateDisplay()
+{
+  if (!displayUp)
+  {
+    if (millis() - displayProbeMs >= displayRetryMs) startDisplay();
+    if (!displayUp) return;
   }
+  if (splashing && (long)(millis() - splashUntilMs) >= 0)
+  {
+    splashing = false;
+    screenPending = (Screen)yards[focusYard].screen;
+  }
+  if(screenPending != SCREEN_NONE && !splashing)
+  {
+    Screen s = screenPending;
+    screenPending = SCREEN_NONE;
+    drawScreen(s);
+  }
+  panel.service(displayBudgetUs);
+  if (!bootDisplayUs && !panel.busy()) bootDisplayUs = bootMark(BOOT_DISPLAY);
+}
+
+//---Asks the bus for the panel first, as the init sequence alone
+//   cannot tell whether one is there.  Without it the sketch runs blind
+//   to the panel and the display task asks again later.  setup() has
+//   started Wire with its timeout.
+void startDisplay()
+{
+  static bool faulted = false;
+  displayProbeMs = millis();
+  Wire.beginTransmission(OLED_ADDR);
+  bool found = Wire.endTransmission() == 0;
+  if (found)                           //--reset pulse; the SSD1306 wants 3us low
+  {
+    pinMode(OLED_RESET, OUTPUT);
+    digitalWrite(OLED_RESET, LOW);
+    delayMicroseconds(10);
+    digitalWrite(OLED_RESET, HIGH);
+  }
+  if (!found || !panel.begin())
+  {
+    if (!faulted) tlmFault(FAULT_DISPLAY);
+    faulted = true;
+    return;
+  }
+  displayUp = true;
+  screenPending = (Screen)yards[focusYard].screen;
+}
+
+//---A frame number (PanelRenderer.h) holds everything a screen shows:
+//   the screen, the track, whether it is shown by name and the yard.
+uint16_t frameOf(Screen s, byte track, bool named, byte yard)
+{
+  return s | track << 4 | named << 8 | yard << 9;
+}
+
+//---Asks for the screen with the focus yard and its track: the one being
+//   chosen, or the one being set up on the ALIGNING screen.  Nothing is
+//   drawn here; the display task sends the pages that change.
+void drawScreen(Screen s)
+{
+  Yard &yd   = yards[focusYard];
+  byte track = (s == SCREEN_ALIGNING) ? yd.tracknumActive : yd.tracknumChoice;
+  panel.show(frameOf(s, track, namedTrack(focusYard, track), focusYard + 1));
+}
+
+//---Draws one page of a frame for the renderer: the page of the screen's
+//   pre-rendered labels (ScreenBitmaps.h), then the yard and track
+//   fields that cross it.
+void composePage(uint16_t frame, byte page, uint8_t *buf)
+{
+  Screen s = (Screen)(frame & 0x0F);
+  const uint8_t *fixed;
+  memcpy_P(&fixed, &screenBitmaps[s], sizeof(fixed));
+
+  if (fixed) unpackScreenPage(buf, fixed, page);
+  else memset(buf, 0, PanelRenderer::WIDTH);
+  drawLayoutPage(buf, page, &screenLayouts[s], (frame >> 4) & 0x0F, frame & 0x100,
+                 frame >> 9, fixed != 0);
 }
 
 //--------------------------------------------------
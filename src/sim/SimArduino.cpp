@@ -0,0 +1,130 @@
+//---------------------------Simulated Arduino Core--------------------------
+// See include/sim/SimArduino.h.  Only built in the native environment.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "MegaPins.h"
+
+HardwareSerial Serial, Serial1;
+
+static uint64_t nowUs = 0;
+static uint8_t  pinLevel[SIM_PINS];
+static uint8_t  pinOut[SIM_PINS];
+static void   (*pinChangeIsr)() = 0;
+
+void simReset()
+{
+  nowUs = 0;
+  memset(pinLevel, HIGH, sizeof(pinLevel));   //--pulled up / sensor clear
+  memset(pinOut, LOW, sizeof(pinOut));
+  pinChangeIsr = 0;
+}
+
+void simAdvanceUs(unsigned long us) { nowUs += us; }
+uint64_t simNowUs() { return nowUs; }
+
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+unsigned long micros() { return (unsigned long)nowUs; }
+void delay(unsigned long ms) { nowUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { nowUs += us; }
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+int digitalRead(uint8_t pin)
+{
+  return pin < SIM_PINS ? pinLevel[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+  if (pin < SIM_PINS) pinOut[pin] = level ? HIGH : LOW;
+}
+
+void simSetPin(uint8_t pin, uint8_t level)
+{
+  if (pin >= SIM_PINS) return;
+  level = level ? HIGH : LOW;
+  if (pinLevel[pin] == level) return;
+  pinLevel[pin] = level;
+  if (pinChangeIsr) pinChangeIsr();
+}
+
+uint8_t simPinOutput(uint8_t pin)
+{
+  return pin < SIM_PINS ? pinOut[pin] : LOW;
+}
+
+void simOnPinChange(void (*isr)())
+{
+  pinChangeIsr = isr;
+}
+
+uint8_t simReadPort(uint8_t port)
+{
+  uint8_t v = 0;
+  for (uint8_t pin = 0; pin < MEGA_PINS; pin++)
+    if (megaPinPort[pin] == port && pinLevel[pin]) v |= megaBitMask(pin);
+  return v;
+}
+
+//---------------------------Print-------------------------------------------
+size_t Print::print(unsigned long n, int base)
+{
+  char buf[8 * sizeof(long) + 1];
+  char *p = buf + sizeof(buf) - 1;
+  *p = 0;
+  if (base < 2) base = 10;
+  do
+  {
+    int digit = n % base;
+    *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    n /= base;
+  }
+  while (n);
+  return print(p);
+}
+
+size_t Print::print(long n, int base)
+{
+  if (base == 10 && n < 0)
+  {
+    return print('-') + print((unsigned long)(-n), base);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (writeHook) writeHook(c);
+  if (peer)
+  {
+    if (noise > 0 && rand() < noise * RAND_MAX) c ^= 1 << (rand() & 7);
+    if (lineFreeUs < nowUs) lineFreeUs = nowUs;
+    lineFreeUs += byteUs;
+    peer->rx.push_back({lineFreeUs, c});
+  }
+  return 1;
+}
+
+int HardwareSerial::available()
+{
+  int n = 0;
+  for (size_t i = 0; i < rx.size() && rx[i].us <= nowUs; i++) n++;
+  return n;
+}
+
+int HardwareSerial::read()
+{
+  if (rx.empty() || rx.front().us > nowUs) return -1;
+  uint8_t c = rx.front().c;
+  rx.pop_front();
+  return c;
+}
+
+void HardwareSerial::simConnect(HardwareSerial &other, unsigned long usPerByte)
+{
+  peer = &other;
+  byteUs = usPerByte;
+  other.peer = this;
+  other.byteUs = usPerByte;
+}
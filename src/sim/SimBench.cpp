@@ -0,0 +1,199 @@
+//---------------------------Pair Logic Benchmark----------------------------
+// Times PairBank (include/PairBank.h) against PairState, the one pair at a
+// time form of the same logic, for 2, 8 and 16 sensor pairs, and checks
+// that the two agree on every pair after every tick.  Only built in the
+// native environment; the figures are host times, useful for comparing
+// the two forms rather than as AVR cycle counts.
+//
+// The workload is generated: each pair sees trains go through in either
+// direction, back out, stall and back out, and long trains that block
+// and unblock In several times, with a random gap before each edge and at
+// most one edge per pair per tick, as the sensor task sees them.
+//
+//   scalar edges   - PairState::update() for each pair that had an edge
+//   scalar scan    - PairState::update() for every pair, every tick, as
+//                    the original sketch polled its sensors
+//   bank           - one PairBank::update() per tick for all the pairs
+//
+// Recorded traces are checked the same way by --replay.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "SensorPair.h"
+#include "PairBank.h"
+#include <chrono>
+#include <vector>
+
+//---busy values a pair goes through, 0 ends each pattern
+static const uint8_t patterns[][7] = {
+  {1, 3, 2, 0},                 //---through, In first
+  {2, 3, 1, 0},                 //---through, Out first
+  {1, 0},                       //---backs out
+  {2, 0},
+  {1, 3, 1, 0},                 //---stalls and backs out
+  {2, 3, 2, 0},
+  {1, 3, 1, 3, 2, 0},           //---long train, gaps between cars
+  {2, 3, 2, 3, 1, 0},
+};
+static const uint8_t PATTERNS = sizeof(patterns) / sizeof(patterns[0]);
+
+static uint32_t rng;
+static uint32_t rnd(uint32_t n)
+{
+  rng = rng * 1664525u + 1013904223u;
+  return (rng >> 8) % n;
+}
+
+struct Workload
+{
+  unsigned pairs;
+  std::vector<uint16_t> inLevels, outLevels;   //---per tick, bit per pair
+  std::vector<uint16_t> changed;               //---pairs with an edge
+  unsigned long edges;
+};
+
+static void generate(Workload &w, unsigned pairs, unsigned long ticks)
+{
+  struct Lane { uint8_t pattern, step, wait; };
+  std::vector<Lane> lanes(pairs);
+  for (unsigned p = 0; p < pairs; p++)
+    lanes[p] = { (uint8_t)rnd(PATTERNS), 0, (uint8_t)rnd(8) };
+
+  w.pairs = pairs;
+  w.edges = 0;
+  w.inLevels.resize(ticks);
+  w.outLevels.resize(ticks);
+  w.changed.resize(ticks);
+  uint16_t in = 0xFFFF, out = 0xFFFF;
+
+  for (unsigned long t = 0; t < ticks; t++)
+  {
+    uint16_t changed = 0;
+    for (unsigned p = 0; p < pairs; p++)
+    {
+      Lane &l = lanes[p];
+      if (l.wait) { l.wait--; continue; }
+
+      uint8_t busy = patterns[l.pattern][l.step];
+      uint16_t bit = 1 << p;
+      in  = busy & 1 ? in & ~bit : in | bit;
+      out = busy & 2 ? out & ~bit : out | bit;
+      changed |= bit;
+      w.edges++;
+
+      if (busy == 0)
+      {
+        l.pattern = rnd(PATTERNS);
+        l.step    = 0;
+        l.wait    = 4 + rnd(40);     //---quiet between trains
+      }
+      else
+      {
+        l.step++;
+        l.wait = rnd(12);
+      }
+    }
+    w.inLevels[t]  = in;
+    w.outLevels[t] = out;
+    w.changed[t]   = changed;
+  }
+}
+
+static volatile unsigned long sink;   //---keeps the timed loops honest
+
+typedef std::chrono::steady_clock Clock;
+static double nsPerTick(Clock::time_point start, unsigned long ticks)
+{
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ticks;
+}
+
+template <class Word>
+static unsigned long check(const Workload &w)
+{
+  std::vector<PairState> scalar(w.pairs);
+  PairBank<Word> bank;
+  bank.reset();
+  for (unsigned p = 0; p < w.pairs; p++) scalar[p].reset();
+
+  unsigned long mismatches = 0;
+  for (size_t t = 0; t < w.inLevels.size(); t++)
+  {
+    bank.update((Word)w.inLevels[t], (Word)w.outLevels[t]);
+    for (unsigned p = 0; p < w.pairs; p++)
+    {
+      PairState &s = scalar[p];
+      s.update((w.inLevels[t] >> p) & 1, (w.outLevels[t] >> p) & 1);
+      if (s.busy != bank.busy(p) || s.direction != bank.direction(p) ||
+          s.lastDirection != bank.lastDirection(p) || s.passBy != bank.passBy(p))
+        mismatches++;
+      s.passBy = false;
+    }
+    bank.clearPassBy((Word)~0);
+  }
+  return mismatches;
+}
+
+template <class Word>
+static bool run(unsigned pairs, unsigned long ticks)
+{
+  Workload w;
+  generate(w, pairs, ticks);
+  unsigned long mismatches = check<Word>(w);
+
+  std::vector<PairState> scalar(pairs);
+  unsigned long passBy = 0;
+
+  for (unsigned p = 0; p < pairs; p++) scalar[p].reset();
+  Clock::time_point start = Clock::now();
+  for (unsigned long t = 0; t < ticks; t++)
+    for (uint16_t c = w.changed[t], p = 0; c; c >>= 1, p++)
+    {
+      if (!(c & 1)) continue;
+      PairState &s = scalar[p];
+      s.update((w.inLevels[t] >> p) & 1, (w.outLevels[t] >> p) & 1);
+      passBy += s.passBy;
+      s.passBy = false;
+    }
+  double edgesNs = nsPerTick(start, ticks);
+
+  for (unsigned p = 0; p < pairs; p++) scalar[p].reset();
+  start = Clock::now();
+  for (unsigned long t = 0; t < ticks; t++)
+    for (unsigned p = 0; p < pairs; p++)
+    {
+      PairState &s = scalar[p];
+      s.update((w.inLevels[t] >> p) & 1, (w.outLevels[t] >> p) & 1);
+      passBy += s.passBy;
+      s.passBy = false;
+    }
+  double scanNs = nsPerTick(start, ticks);
+
+  PairBank<Word> bank;
+  bank.reset();
+  start = Clock::now();
+  for (unsigned long t = 0; t < ticks; t++)
+  {
+    bank.update((Word)w.inLevels[t], (Word)w.outLevels[t]);
+    passBy += __builtin_popcount(bank.passByMask());
+    bank.clearPassBy((Word)~0);
+  }
+  double bankNs = nsPerTick(start, ticks);
+  sink = passBy;
+
+  printf("%2u pairs  %9lu edges  scalar edges %6.2f  scalar scan %6.2f  bank %6.2f ns/tick"
+         "  (%4.1fx, %4.1fx)  %lu differ\n",
+         pairs, w.edges, edgesNs, scanNs, bankNs,
+         bankNs > 0 ? edgesNs / bankNs : 0.0, bankNs > 0 ? scanNs / bankNs : 0.0,
+         mismatches);
+  return mismatches == 0;
+}
+
+int pairBench(unsigned long ticks, uint32_t seed)
+{
+  rng = seed;
+  if (ticks == 0) ticks = 1;
+  bool ok = run<uint8_t>(2, ticks);
+  ok = run<uint8_t>(8, ticks) && ok;
+  ok = run<uint16_t>(16, ticks) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+//---------------------------Simulated Devices-------------------------------
+// See include/sim/SimDevices.h.  Only built in the native environment.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+
+TwoWire Wire;
+
+//---------------------------TwoWire-----------------------------------------
+void TwoWire::beginTransmission(uint8_t address)
+{
+  addr = address;
+  len  = 0;
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+  if (len >= sizeof(buf)) return 0;     //--same 32 byte limit as AVR Wire
+  buf[len++] = c;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool stop)
+{
+  (void)stop;
+  if (!begun) beforeBegin++;
+  if (simNack)                         //--address not acknowledged
+  {
+    simAdvanceUs((unsigned long)(9 * 1000000ULL / clockHz) + 20);
+    len = 0;
+    return 2;
+  }
+  //---address + data, 9 clocks a byte, plus start/stop and library time
+  simAdvanceUs((unsigned long)((len + 1) * 9 * 1000000ULL / clockHz) + 20);
+  bytes += len;
+  transactions++;
+  if (onTransmit) onTransmit(addr, buf, len);
+  len = 0;
+  return 0;
+}
+
+//---------------------------SimOled----------------------------------------
+static SimOled *simPanel = 0;
+SimOled simOled(Wire, 0x3C);
+
+//---RAM is noise at power up, as on a real panel, so a page the sketch
+//   never sent shows up in a check
+SimOled::SimOled(TwoWire &bus, uint8_t address)
+  : i2caddr(address)
+{
+  for (size_t i = 0; i < sizeof(ram); i++) ram[i] = (uint8_t)(i * 37 + 11);
+  simPanel = this;
+  bus.onTransmit = transmit;
+}
+
+void SimOled::transmit(uint8_t address, const uint8_t *data, size_t n)
+{
+  if (simPanel && address == simPanel->i2caddr) simPanel->receive(data, n);
+}
+
+//---Decode one I2C transaction the way the SSD1306 would: a control byte
+//   of 0x00 means commands follow, 0x40 means display RAM data.
+void SimOled::receive(const uint8_t *data, size_t n)
+{
+  if (n == 0) return;
+
+  if (data[0] == 0x40)
+  {
+    for (size_t i = 1; i < n; i++)
+    {
+      ram[page * 128 + col] = data[i];
+      if (++col > colEnd)
+      {
+        col = colStart;
+        if (++page > pageEnd) page = pageStart;
+      }
+    }
+    return;
+  }
+
+  for (size_t i = 1; i < n; i++)
+  {
+    uint8_t c = data[i];
+    if (cmdArgs)
+    {
+      cmdBuf[cmdPending++] = c;
+      if (--cmdArgs) continue;
+      if (cmdBuf[0] == 0x21)
+      {
+        colStart = col = cmdBuf[1] & 0x7F;
+        colEnd   = c & 0x7F;
+      }
+      else if (cmdBuf[0] == 0x22)
+      {
+        pageStart = page = cmdBuf[1] & 0x07;
+        pageEnd   = c & 0x07;
+      }
+      continue;
+    }
+
+    cmdPending = 0;
+    if (c == 0x21 || c == 0x22)
+    {
+      cmdBuf[cmdPending++] = c;
+      cmdArgs = 2;
+    }
+    else if (c == 0x20 || c == 0x81 || c == 0x8D || c == 0xA8 || c == 0xD3 ||
+             c == 0xD5 || c == 0xD9 || c == 0xDA || c == 0xDB)
+    {
+      cmdBuf[cmdPending++] = c;     //--one argument, not acted on
+      cmdArgs = 1;
+    }
+    else if (c == 0xAE) on = false;
+    else if (c == 0xAF) on = true;
+  }
+}
+
+//---------------------------EEPROM------------------------------------------
+uint8_t  simEeprom[SIM_EEPROM_SIZE];
+uint32_t simEepromWrites[SIM_EEPROM_SIZE];
+static uint64_t eepromBusyUntil = 0;
+static bool     eepromErased = false;
+
+static void eepromInit()
+{
+  if (eepromErased) return;
+  memset(simEeprom, 0xFF, sizeof(simEeprom));   //--as shipped
+  eepromErased = true;
+}
+
+void simEepromErase()
+{
+  memset(simEeprom, 0xFF, sizeof(simEeprom));
+  memset(simEepromWrites, 0, sizeof(simEepromWrites));
+  eepromErased = true;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+  eepromInit();
+  uintptr_t a = (uintptr_t)addr;
+  return a < SIM_EEPROM_SIZE ? simEeprom[a] : 0xFF;
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+  eepromInit();
+  if (simNowUs() < eepromBusyUntil) simAdvanceUs((unsigned long)(eepromBusyUntil - simNowUs()));
+  uintptr_t a = (uintptr_t)addr;
+  if (a >= SIM_EEPROM_SIZE) return;
+  simEeprom[a] = value;
+  simEepromWrites[a]++;
+  eepromBusyUntil = simNowUs() + 3400;
+}
+
+bool eeprom_is_ready()
+{
+  return simNowUs() >= eepromBusyUntil;
+}
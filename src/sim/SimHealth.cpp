@@ -0,0 +1,169 @@
+//---------------------------Sensor Health Test------------------------------
+// Runs the sketch with one failing detector in each yard and checks that
+// the health monitor (SensorHealth.h) and the adaptive debounce
+// (EdgeCapture.h) deal with it:
+//
+//   yard 1 - main In bounces for 1.5ms on every edge, longer than any
+//            simulated yard does: its window must grow past 4x that and
+//            no glitch may become an edge.  Its partner never sees the
+//            trains, so it must be flagged STUCK_CLEAR, until it does.
+//   yard 2 - main In chatters every 30ms, too slow for any window: it
+//            must be flagged CHATTER, and the yard must not stay
+//            OCCUPIED on it; once it is quiet it must be trusted again.
+//   yard 3 - main In stays blocked: OCCUPIED until sensStuckMs, then
+//            STUCK_BLOCKED and the yard goes back to work; clearing it
+//            ends that.
+//   yard 4 - a train stands over both detectors of the main pair for
+//            longer than sensStuckMs: that is a train, not a fault.
+//   yard 1 - last, its reverse In flickers faster than the sensor task
+//            drains the raw ring and ends clear: the events lost in the
+//            overrun must not leave it blocked.
+//   yard 2 - last, the sensor task stalls while its main pair clears
+//            and then edges more often than the accepted edge ring
+//            holds: the clearing edge is dropped, and the pair must
+//            still come out clear.
+//
+// Only built in the native environment.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "EdgeCapture.h"
+#include "SensorHealth.h"
+#include "Yard.h"
+#include "sim/SimYard.h"
+
+void setup();
+void loop();
+
+static unsigned long failures;
+
+//---run the sketch for ms of simulated time, a loop() per millisecond
+static void run(unsigned long ms)
+{
+  for (unsigned long i = 0; i < ms; i++)
+  {
+    loop();
+    simAdvanceUs(1000);
+  }
+}
+
+static void set(byte sensor, byte level)
+{
+  simSetPin(sensorPin(sensor), level);
+}
+
+static void expect(bool ok, const char *what)
+{
+  printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+  if (!ok) failures++;
+}
+
+static byte yardState(byte y)
+{
+  return yards[y].machine.state();
+}
+
+int healthTest()
+{
+  simReset();
+  setup();
+  run(1000);
+  failures = 0;
+
+  //---yard 1: bouncing In, dead Out
+  const byte bouncy = 0 * SENSORS_PER_YARD + MAIN_IN, deaf = bouncy + 1;
+  for (int train = 0; train < 20; train++)
+  {
+    for (byte level = LOW; ; level = HIGH)
+    {
+      set(bouncy, level);
+      run(1);
+      simAdvanceUs(500);              //--1.5ms in all, then back and settle
+      set(bouncy, !level);
+      run(1);
+      set(bouncy, level);
+      run(level == LOW ? 2000 : 3000);
+      if (level == HIGH) break;
+    }
+  }
+  printf("yard 1           window %lu us, %u glitches, %u edges\n",
+         edgeCapture.window(bouncy), edgeCapture.glitches(bouncy),
+         sensorHealth.edges(bouncy));
+  expect(edgeCapture.window(bouncy) >= 4 * 1500UL, "bouncing sensor's window grown");
+  expect(sensorHealth.edges(bouncy) == 40, "no glitch taken for an edge");
+  expect(sensorHealth.condition(bouncy) == SENSOR_OK, "bouncing sensor still trusted");
+  expect(sensorHealth.condition(deaf) == SENSOR_STUCK_CLEAR, "dead partner flagged stuck clear");
+  set(deaf, LOW);
+  run(1000);
+  set(deaf, HIGH);
+  run(1000);
+  expect(sensorHealth.condition(deaf) == SENSOR_OK, "and trusted again once it sees a train");
+
+  //---yard 2: chatter
+  const byte chatty = 1 * SENSORS_PER_YARD + MAIN_IN;
+  for (int i = 0; i < 100; i++)
+  {
+    set(chatty, i & 1 ? HIGH : LOW);
+    run(30);
+  }
+  set(chatty, LOW);                   //--and it leaves it blocked
+  run(2000);
+  printf("yard 2           busiest second %u edges\n", sensorHealth.busiestSecond(chatty));
+  expect(sensorHealth.condition(chatty) == SENSOR_CHATTER, "chattering sensor flagged");
+  expect(yardState(1) != SimStates::OCCUPIED, "its yard not held OCCUPIED by it");
+  set(chatty, HIGH);
+  run((SensorHealth::QUIET_S + 1) * 1000UL);
+  expect(sensorHealth.condition(chatty) == SENSOR_OK, "trusted again after a quiet spell");
+
+  //---yard 3: stuck blocked; yard 4: a train standing over a whole pair
+  const byte stuck = 2 * SENSORS_PER_YARD + MAIN_IN;
+  const byte train = 3 * SENSORS_PER_YARD + MAIN_IN;
+  set(stuck, LOW);
+  set(train, LOW);
+  set(train + 1, LOW);
+  run(1000);
+  expect(yardState(2) == SimStates::OCCUPIED, "blocked sensor makes its yard OCCUPIED");
+  run(sensStuckMs + 2000);
+  expect(sensorHealth.condition(stuck) == SENSOR_STUCK_BLOCKED, "then flagged stuck blocked");
+  expect(yardState(2) != SimStates::OCCUPIED, "and its yard back at work");
+  expect(sensorHealth.condition(train) == SENSOR_OK &&
+         sensorHealth.condition(train + 1) == SENSOR_OK, "a train over both is not a fault");
+  expect(yardState(3) == SimStates::OCCUPIED, "and keeps its yard OCCUPIED");
+  printf("yard 3           longest blocked %.1f s\n", sensorHealth.longestBlocked(stuck) / 10.0);
+  set(stuck, HIGH);
+  run(1000);
+  expect(sensorHealth.condition(stuck) == SENSOR_OK, "stuck sensor trusted again once it clears");
+
+  //---yard 1: a burst that overruns the raw ring, ending clear
+  const byte noisy = 0 * SENSORS_PER_YARD + REV_IN;
+  unsigned long lostWas = edgeCapture.rawOverruns();
+  for (int i = 0; i < 2 * EdgeCapture::RAW_SIZE + 2; i++)
+  {
+    set(noisy, i & 1 ? HIGH : LOW);
+    simAdvanceUs(20);
+  }
+  run(100);
+  expect(edgeCapture.rawOverruns() != lostWas, "raw ring overrun");
+  expect(edgeCapture.read(noisy) == HIGH, "sensor clear after the overrun");
+
+  //---yard 2: more debounced edges than the ring holds between two drains,
+  //   but too few raw events to overrun the raw ring
+  const byte lead = 1 * SENSORS_PER_YARD + MAIN_IN, tail = lead + 1;
+  const unsigned long stableUs = 25000;   //--past the longest window
+  set(lead, LOW);
+  run(100);
+  unsigned long edgeLostWas = edgeCapture.edgeOverruns();
+  set(lead, HIGH);
+  for (int i = 0; i < EdgeCapture::EDGE_SIZE + 4; i++)
+  {
+    simAdvanceUs(stableUs);
+    set(tail, i & 1 ? HIGH : LOW);    //--ends clear
+  }
+  simAdvanceUs(stableUs);
+  run(100);
+  expect(edgeCapture.edgeOverruns() != edgeLostWas, "edge ring overrun");
+  expect(pairBank.busy(lead >> 1) == 0, "pair clear after the edge overrun");
+
+  printf("failures         %lu\n", failures);
+  return failures ? 1 : 0;
+}
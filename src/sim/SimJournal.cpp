@@ -0,0 +1,104 @@
+//---------------------------Journal Power Cut Test--------------------------
+// Runs the warm start journal (Journal.h) on the simulated EEPROM through
+// N random commits, cutting the power at random bytes of the writes.
+// After each cut a fresh Journal scans the EEPROM, and every yard must
+// come back as one of the entries it committed since the journal last
+// drained, or the one it had then - never anything older, never garbage.
+// Reports the wear: the most writes any byte of the ring took against an
+// even spread.  Only built in the native environment.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "Journal.h"
+#include <vector>
+
+//---each service() writes at most a byte; give the EEPROM time for it
+static void step(Journal &j)
+{
+  j.service();
+  simAdvanceUs(3400);
+}
+
+//---nothing being written and nothing waiting
+static bool drained(Journal &j)
+{
+  if (j.busy()) return false;
+  j.service();
+  return !j.busy();
+}
+
+static bool same(const JournalEntry &a, const JournalEntry &b)
+{
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+int journalTest(unsigned long commits, uint32_t seed)
+{
+  const uint16_t bytes = 1024;
+  srand(seed);
+  simReset();
+  simEepromErase();
+
+  //---what each yard may come back as: the first is on the EEPROM for
+  //   certain (if durable), the rest have been committed since
+  std::vector<JournalEntry> allowed[Journal::MAX_YARDS];
+  bool durable[Journal::MAX_YARDS] = {};
+
+  Journal j;
+  j.begin(0, bytes);
+  unsigned long cuts = 0, recalled = 0, wrong = 0, records = 0;
+  for (unsigned long n = 0; n < commits; n++)
+  {
+    //---the last two yards are quiet for longer than the ring lasts
+    byte y = rand() % 512 ? rand() % 2 : 2 + rand() % 2;
+    JournalEntry e = { (byte)(rand() % 6), (byte)(rand() & 0x1F), (byte)(rand() & 0x1F),
+                       (byte)(rand() & 3) };
+    j.commit(y, e);
+    allowed[y].push_back(e);
+
+    //---up to two records' worth of bytes, then maybe the power goes
+    int k = rand() % (2 * Journal::RECORD + 3);
+    for (int i = 0; i < k; i++) step(j);
+    if (drained(j))
+      for (byte i = 0; i < Journal::MAX_YARDS; i++)
+        if (!allowed[i].empty())
+        {
+          allowed[i].erase(allowed[i].begin(), allowed[i].end() - 1);
+          durable[i] = true;
+        }
+    if (rand() % 4) continue;
+
+    cuts++;
+    records += j.written();
+    j.begin(0, bytes);
+    for (byte i = 0; i < Journal::MAX_YARDS; i++)
+    {
+      JournalEntry r;
+      bool have = j.recall(i, r), ok = !have && !durable[i];
+      for (size_t a = 0; have && a < allowed[i].size(); a++)
+        if (same(r, allowed[i][a])) ok = true;
+      if (!ok) wrong++;
+      allowed[i].clear();
+      if (have)
+      {
+        recalled++;
+        allowed[i].push_back(r);
+      }
+      durable[i] = have;
+    }
+  }
+  while (!drained(j)) step(j);
+  records += j.written();
+
+  uint32_t worst = 0;
+  for (uint16_t a = 0; a < bytes; a++)
+    if (simEepromWrites[a] > worst) worst = simEepromWrites[a];
+  double even = (double)records * Journal::RECORD / bytes;
+
+  printf("journal          %lu commits, %lu records, %lu power cuts, %lu yards recalled,"
+         " %lu wrong\n", commits, records, cuts, recalled, wrong);
+  printf("wear             worst byte %lu writes, %.1f if spread evenly (%.2fx)\n",
+         (unsigned long)worst, even, even > 0 ? worst / even : 0.0);
+  printf("failures         %d\n", wrong ? 1 : 0);
+  return wrong ? 1 : 0;
+}
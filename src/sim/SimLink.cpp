@@ -0,0 +1,151 @@
+//---------------------------Motor Link over a PTY---------------------------
+// Runs both ends of the motor link (MotorLink.h) in one process, joined by
+// a pseudo-terminal as a USB serial adapter would join the panel and the
+// driver Pro-Mini, with simulated time following the wall clock.  Each
+// end sends N numbered frames to the other as fast as its queue takes
+// them, and each checks that the other's arrive exactly once and in
+// order.  With --link-noise some of the bytes written get a bit flipped,
+// so CRC failures, lost acks and resends all happen.  Only built in the
+// native environment.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "MotorLink.h"
+#include <chrono>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+//---one end of the pty as a Stream
+class FdStream : public Stream
+{
+  public:
+    FdStream(int fd, double noise) : fd(fd), noise(noise) {}
+
+    size_t write(uint8_t c)
+    {
+      if (noise > 0 && rand() < noise * RAND_MAX) c ^= 1 << (rand() & 7);
+      while (::write(fd, &c, 1) != 1) usleep(100);
+      return 1;
+    }
+    using Print::write;
+    int available() { fill(); return len - pos; }
+    int read()      { fill(); return pos < len ? buf[pos++] : -1; }
+
+  private:
+    void fill()
+    {
+      if (pos < len) return;
+      ssize_t n = ::read(fd, buf, sizeof(buf));
+      pos = 0;
+      len = n > 0 ? (int)n : 0;
+    }
+
+    int     fd;
+    double  noise;
+    uint8_t buf[256];
+    int     pos = 0, len = 0;
+};
+
+struct End
+{
+  MotorLink     link;
+  unsigned long sent, taken, wrong;
+};
+static End ends[2];
+
+//---payload: the frame's number, then filler from it
+static void fill(byte *p, unsigned long n, byte len)
+{
+  memcpy(p, &n, sizeof(n));
+  for (byte i = sizeof(n); i < len; i++) p[i] = (byte)(n * 31 + i);
+}
+
+static void take(End &e, byte type, const byte *payload, byte len)
+{
+  byte want[MotorLink::MAX_PAYLOAD];
+  byte wantLen = 4 + e.taken % (MotorLink::MAX_PAYLOAD - 3);
+  fill(want, e.taken, wantLen);
+  if (type != LINK_STATUS || len != wantLen || memcmp(payload, want, len)) e.wrong++;
+  e.taken++;
+}
+static void takePanel(byte type, const byte *p, byte len)  { take(ends[0], type, p, len); }
+static void takeDriver(byte type, const byte *p, byte len) { take(ends[1], type, p, len); }
+
+static int openPty(int &slave, const char *&name)
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) || unlockpt(master)) return -1;
+  name  = ptsname(master);
+  slave = open(name, O_RDWR | O_NOCTTY);
+  if (slave < 0) return -1;
+
+  termios t;
+  tcgetattr(slave, &t);
+  cfmakeraw(&t);                     //--no echo, no line editing, 8 bits clean
+  tcsetattr(slave, TCSANOW, &t);
+  fcntl(master, F_SETFL, O_NONBLOCK);
+  fcntl(slave, F_SETFL, O_NONBLOCK);
+  return master;
+}
+
+int linkPtyTest(unsigned long frames, double noise, uint32_t seed)
+{
+  int slave;
+  const char *name;
+  int master = openPty(slave, name);
+  if (master < 0)
+  {
+    fprintf(stderr, "no pseudo-terminal\n");
+    return 2;
+  }
+  srand(seed);
+  simReset();
+
+  FdStream panelPort(master, noise), driverPort(slave, noise);
+  ends[0] = End();
+  ends[1] = End();
+  ends[0].link.begin(panelPort, takePanel, 20, 0);
+  ends[1].link.begin(driverPort, takeDriver, 20, 0);
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now(), last = start;
+  bool done = false;
+  while (!done)
+  {
+    Clock::time_point now = Clock::now();
+    simAdvanceUs((unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+    last = now;
+    if (now - start > std::chrono::seconds(60)) break;
+
+    done = true;
+    for (int i = 0; i < 2; i++)
+    {
+      End &e = ends[i];
+      byte p[MotorLink::MAX_PAYLOAD];
+      byte len = 4 + e.sent % (MotorLink::MAX_PAYLOAD - 3);
+      fill(p, e.sent, len);
+      if (e.sent < frames && e.link.send(LINK_STATUS, p, len)) e.sent++;
+      e.link.poll();
+      done = done && e.sent == frames && e.link.idle() && ends[1 - i].taken == frames;
+    }
+    usleep(50);
+  }
+  double wall = std::chrono::duration<double>(Clock::now() - start).count();
+  close(slave);
+  close(master);
+
+  bool ok = done;
+  printf("link pty         %s, %lu frames each way, %.1f%% of bytes corrupted, %.2f s\n",
+         name, frames, noise * 100, wall);
+  for (int i = 0; i < 2; i++)
+  {
+    const End &e = ends[i];
+    printf("  %-6s         %lu frames on the line, %lu resent, %lu bad; took %lu, %lu wrong\n",
+           i ? "driver" : "panel", e.link.framesSent(), e.link.resent(),
+           e.link.badFrames(), e.taken, e.wrong);
+    ok = ok && e.wrong == 0 && e.taken == frames;
+  }
+  printf("failures         %d\n", ok ? 0 : 1);
+  return ok ? 0 : 1;
+}
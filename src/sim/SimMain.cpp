@@ -0,0 +1,386 @@
+//---------------------------Native Simulator Entry--------------------------
+// Runs the sketch's setup()/loop() against the simulated yard on
+// simulated time.  Exit status is non-zero if any movement did not produce
+// the expected states, so it can gate changes to the sketch.
+//
+//   program [--movements N] [--step-us N] [--seed N] [--telemetry FILE]
+//           [--record-trace FILE] [--link-noise P] [--oled-after MS]
+//           [--driver-after MS] [--driver-reset MS] [--profile] [--verbose]
+//   program --replay FILE [--repeat N] [--verbose]
+//   program --bench-pairs [--ticks N] [--seed N]
+//   program --link-pty [--frames N] [--link-noise P] [--seed N]
+//   program --journal-test [--commits N] [--seed N]
+//   program --health-test
+//   program --dump-states
+//
+// --step-us is how far simulated time moves between loop() calls when
+// nothing else is due.  1000 (the default) matches the sensor task period;
+// larger steps trade reaction-time resolution for speed when benchmarking.
+//
+// --record-trace saves the sensor edges of the run, with a MARK for every
+// PassBy the yard expects, as a trace (include/sim/Trace.h).  --replay
+// runs a trace through the sensor logic instead of simulating the yard;
+// --repeat plays it back to back N times for throughput figures.
+// --bench-pairs times the sensor pair logic, PairBank against PairState,
+// over N sensor task ticks (src/sim/SimBench.cpp).
+// --link-noise flips a bit in that fraction of the bytes on the line
+// between the sketch and the motor driver, both ways.  --link-pty runs
+// the two ends of the motor link (MotorLink.h) over a pseudo-terminal,
+// real bytes in real time, and checks that N frames each way arrive once
+// and in order through the noise (src/sim/SimLink.cpp).
+// --journal-test makes N random commits to the warm start journal
+// (Journal.h), cutting the power part way through its writes, and checks
+// what comes back after each (src/sim/SimJournal.cpp).  A normal run also
+// checks at the end that the journal holds every yard as it is.
+// --health-test gives each yard a failing detector - bouncing, dead,
+// chattering, stuck - and checks the sketch sees it and carries on
+// (src/sim/SimHealth.cpp).  In a normal run the detectors are sound, so
+// the run fails if one is flagged as chattering or stuck blocked.
+// --oled-after leaves the bus without the panel for the first MS of the
+// run, 0 for the whole run; the yards must not notice.  Whenever the
+// panel has caught up with a new screen, its RAM (SimOled) must match
+// the screen composed from scratch, and nothing may use the bus before
+// Wire.begin().  --driver-after keeps the motor
+// driver deaf for the first MS, so the panel's link queue fills; the
+// movements in that time fail, as they would on the layout.
+// --driver-reset resets the driver while the first route after MS is
+// being set up, as a brown-out of the Pro-Mini would; the panel must
+// put the route and every yard's power back without a failure.  Every run
+// ends by letting the link drain, and fails if the driver's relays and
+// turnouts are not where the panel has them.  Every run fails
+// if the sensors or the state machine are not going within bootTargetUs
+// of reset.
+// --profile sends the sketch a 'P' at the end of the run and runs on
+// until its histogram dump (Scheduler.h) is out, so --telemetry captures
+// it for tools/render_profile.py.  Run times are simulated time, so they
+// show the bus transfers and little else.
+// --dump-states prints the sketch's state transition table.
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "sim/SimYard.h"
+#include "sim/Trace.h"
+#include "MotorLink.h"
+#include "MotorDriver.h"
+#include "Journal.h"
+#include "Scheduler.h"
+#include "PanelRenderer.h"
+#include "SensorHealth.h"
+#include "EdgeCapture.h"
+#include <chrono>
+#include <climits>
+
+void setup();
+void loop();
+void dumpStates(Print &out);
+int  pairBench(unsigned long ticks, uint32_t seed);
+int  linkPtyTest(unsigned long frames, double noise, uint32_t seed);
+int  journalTest(unsigned long commits, uint32_t seed);
+int  healthTest();
+extern MotorLink motorLink;
+extern Scheduler scheduler;
+extern int dumpTask;
+extern PanelRenderer panel;
+extern bool displayUp;
+void composePage(uint16_t frame, byte page, uint8_t *buf);
+
+//---Print to stdout, for --dump-states
+class StdoutPrint : public Print
+{
+  public:
+    size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+static const unsigned long bootTargetUs = 50000;
+
+//---once the renderer has caught up, the panel's RAM must hold the frame
+//   the sketch wants, byte for byte, as composed from scratch
+static bool panelShowsFrame()
+{
+  uint8_t page[PanelRenderer::WIDTH];
+  for (byte p = 0; p < PanelRenderer::PAGES; p++)
+  {
+    composePage(panel.frame(), p, page);
+    if (memcmp(page, simOled.ram + p * PanelRenderer::WIDTH, sizeof(page))) return false;
+  }
+  return simOled.on;
+}
+
+static SimYard *yard = 0;
+static FILE    *telemetryOut = 0;
+
+static void onSerial(uint8_t c)
+{
+  if (telemetryOut) fputc(c, telemetryOut);
+  yard->onTelemetry(c);
+}
+
+//---the motor driver's end of Serial1, and its outputs
+static HardwareSerial driverSerial;
+static void onMotor(byte y, byte turnout, bool reverse) { yard->onMotor(y, turnout, reverse); }
+static void onPower(byte y, bool on) { yard->onPower(y, on); }
+
+int main(int argc, char **argv)
+{
+  unsigned long movements = 1000, stepUs = 1000;
+  uint32_t      seed = 1;
+  bool          verbose = false;
+  const char   *replay = 0, *recordTrace = 0;
+  unsigned long repeat = 1, ticks = 1000000;
+  bool          bench = false, pty = false, journaling = false, profile = false;
+  bool          health = false;
+  double        linkNoise = 0;
+  unsigned long frames = 1000, commits = 100000;
+  long          oledAfterMs = -1;
+  long          driverAfterMs = 0;
+  long          driverResetMs = -1;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : 0;
+    if (!strcmp(a, "--movements") && v)      { movements = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--step-us") && v)   { stepUs = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--seed") && v)      { seed = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--telemetry") && v) { telemetryOut = fopen(v, "wb"); i++; }
+    else if (!strcmp(a, "--record-trace") && v) { recordTrace = v; i++; }
+    else if (!strcmp(a, "--replay") && v)    { replay = v; i++; }
+    else if (!strcmp(a, "--repeat") && v)    { repeat = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--ticks") && v)     { ticks = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--link-noise") && v) { linkNoise = strtod(v, 0); i++; }
+    else if (!strcmp(a, "--frames") && v)    { frames = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--commits") && v)   { commits = strtoul(v, 0, 0); i++; }
+    else if (!strcmp(a, "--oled-after") && v) { oledAfterMs = strtol(v, 0, 0); i++; }
+    else if (!strcmp(a, "--driver-after") && v) { driverAfterMs = strtol(v, 0, 0); i++; }
+    else if (!strcmp(a, "--driver-reset") && v) { driverResetMs = strtol(v, 0, 0); i++; }
+    else if (!strcmp(a, "--bench-pairs"))    { bench = true; }
+    else if (!strcmp(a, "--link-pty"))       { pty = true; }
+    else if (!strcmp(a, "--journal-test"))   { journaling = true; }
+    else if (!strcmp(a, "--health-test"))    { health = true; }
+    else if (!strcmp(a, "--profile"))        { profile = true; }
+    else if (!strcmp(a, "--verbose"))        { verbose = true; }
+    else if (!strcmp(a, "--dump-states"))
+    {
+      StdoutPrint out;
+      dumpStates(out);
+      return 0;
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--movements N] [--step-us N] [--seed N] "
+                      "[--telemetry FILE] [--record-trace FILE] [--link-noise P]\n"
+                      "          [--oled-after MS] [--driver-after MS] [--driver-reset MS] [--profile]\n"
+                      "          [--verbose]\n"
+                      "       %s --replay FILE [--repeat N] [--verbose]\n"
+                      "       %s --bench-pairs [--ticks N] [--seed N]\n"
+                      "       %s --link-pty [--frames N] [--link-noise P] [--seed N]\n"
+                      "       %s --journal-test [--commits N] [--seed N]\n"
+                      "       %s --health-test\n"
+                      "       %s --dump-states\n",
+              argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+      return 2;
+    }
+  }
+  if (stepUs == 0) stepUs = 1;
+  if (replay) return traceReplay(replay, repeat, verbose);
+  if (bench) return pairBench(ticks, seed);
+  if (pty) return linkPtyTest(frames, linkNoise, seed);
+  if (journaling) return journalTest(commits, seed);
+  if (health) return healthTest();
+
+  simReset();
+  SimYard sim(seed, stepUs);
+  sim.setVerbose(verbose);
+  yard = &sim;
+  TraceWriter trace;
+  if (recordTrace)
+  {
+    if (!trace.open(recordTrace))
+    {
+      fprintf(stderr, "%s: cannot write\n", recordTrace);
+      return 2;
+    }
+    sim.setTrace(&trace);
+  }
+  Serial.onWrite(onSerial);
+  srand(seed);
+  Serial1.simConnect(driverSerial, 10000000UL / linkBaud);   //--10 bits a byte
+  Serial1.simNoise(linkNoise);
+  driverSerial.simNoise(linkNoise);
+  byte driverBoots = 0;              //--the Pro-Mini's own EEPROM count (MotorLink.h)
+  motorDriver.begin(driverSerial, onMotor, onPower, tortiThrowMs, tortiSettleMs,
+                    tortiPerStep, tortiStaggerMs, ++driverBoots);
+
+  auto wallStart = std::chrono::steady_clock::now();
+  unsigned long loops = 0;
+
+  Wire.simNack = oledAfterMs >= 0;
+  setup();
+  bool asked = false;
+  uint64_t askedUs = 0;
+  unsigned long panelChecks = 0, panelFailures = 0;
+  long checkedFrame = -1;
+  while (sim.stats().movements < movements ||
+         (profile && (!asked || dumpTask >= 0 || simNowUs() - askedUs < 100000)))
+  {
+    if (oledAfterMs > 0 && simNowUs() >= (uint64_t)oledAfterMs * 1000) Wire.simNack = false;
+    if (profile && !asked && sim.stats().movements >= movements)
+    {
+      const Histogram &pass = scheduler.loopHist(), &shown = scheduler.find("display")->runHist;
+      printf("profile          loop pass p99 %lu us, max %lu us; display run p99 %lu us,"
+             " max %lu us; sensors missed %lu\n", pass.percentileUs(99), pass.maxUs,
+             shown.percentileUs(99), shown.maxUs, scheduler.find("sensors")->missed);
+      Serial.simReceive('P');
+      asked = true;
+      askedUs = simNowUs();
+    }
+    if (driverResetMs >= 0 && simNowUs() >= (uint64_t)driverResetMs * 1000)
+      for (byte y = 0; y < YARD_COUNT; y++)
+        if (yards[y].machine.state() == SimStates::TRACK_SETUP && !yards[y].routeSet)
+        {
+          printf("%12.6fs  driver reset while yard %u sets up its route\n",
+                 simNowUs() / 1e6, y + 1);
+          motorDriver.begin(driverSerial, onMotor, onPower, tortiThrowMs, tortiSettleMs,
+                            tortiPerStep, tortiStaggerMs, ++driverBoots);
+          sim.driverReset();
+          driverResetMs = -1;
+          break;
+        }
+    sim.fireDue();
+    loop();
+    if (simNowUs() >= (uint64_t)driverAfterMs * 1000) motorDriver.poll();
+    loops++;
+    sim.observe();
+    if (displayUp && !panel.busy() && panel.frame() != checkedFrame)
+    {
+      checkedFrame = panel.frame();
+      panelChecks++;
+      if (!panelShowsFrame())
+      {
+        printf("panel: frame %04lx not what the panel shows\n", checkedFrame);
+        panelFailures++;
+      }
+    }
+
+    uint64_t now  = simNowUs();
+    uint64_t next = now + stepUs;
+    if (sim.nextActionUs() < next) next = sim.nextActionUs();
+    if (next > now) simAdvanceUs((unsigned long)(next - now));
+  }
+
+  double wall = std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - wallStart).count();
+  double simSeconds = simNowUs() / 1e6;
+
+  //---let the link drain, then the driver must have what the panel has
+  unsigned long linkFailures = 0;
+  for (int ms = 0; ms < 10000; ms++)
+  {
+    loop();
+    motorDriver.poll();
+    simAdvanceUs(1000);
+  }
+  for (byte y = 0; y < YARD_COUNT; y++)
+  {
+    if ((yards[y].railPower == 0) != sim.railPower(y) ||      //--ON is 0
+        ((sim.points(y) ^ routeAligner.position(y)) & routeAligner.known(y)))
+    {
+      printf("yard %u: the driver does not have the yard as the panel has it\n", y + 1);
+      linkFailures++;
+    }
+  }
+
+  //---let the journal finish, then scan it as the next boot would
+  unsigned long journalFailures = 0;
+  while (journal.busy()) { journal.service(); simAdvanceUs(1000); }
+  journal.service();
+  while (journal.busy()) { journal.service(); simAdvanceUs(1000); }
+  unsigned long journalRecords = journal.written();
+  Journal rescan;
+  rescan.begin(journalBase, journalBytes);
+  for (byte y = 0; y < YARD_COUNT; y++)
+  {
+    JournalEntry e, now = yardEntry(y);
+    if (!rescan.recall(y, e) || memcmp(&e, &now, sizeof(e)))
+    {
+      printf("yard %u: journal does not hold the yard as it is\n", y + 1);
+      journalFailures++;
+    }
+  }
+  uint32_t wear = 0;
+  for (uint16_t a = journalBase; a < journalBase + journalBytes; a++)
+    if (simEepromWrites[a] > wear) wear = simEepromWrites[a];
+  const SimYard::Stats &st = sim.stats();
+  unsigned long bootFailures = 0;
+  if (!bootSensorsUs || bootSensorsUs > bootTargetUs || !bootControlUs ||
+      bootControlUs > bootTargetUs)
+  {
+    printf("boot: sensors or state machine not going within %.0f ms\n", bootTargetUs / 1e3);
+    bootFailures++;
+  }
+  if (Wire.beforeBegin)
+  {
+    printf("boot: %lu I2C transfers before Wire.begin()\n", Wire.beforeBegin);
+    bootFailures++;
+  }
+  unsigned long healthFailures = st.flagged[SENSOR_CHATTER] + st.flagged[SENSOR_STUCK_BLOCKED];
+  if (healthFailures) printf("sensor health: a sound detector was taken for a faulty one\n");
+  unsigned long windowMin = ULONG_MAX, windowMax = 0, glitches = 0;
+  for (byte i = 0; i < SENSOR_COUNT; i++)
+  {
+    if (sensorPin(i) == NO_PIN) continue;
+    unsigned long w = edgeCapture.window(i);
+    if (w < windowMin) windowMin = w;
+    if (w > windowMax) windowMax = w;
+    glitches += edgeCapture.glitches(i);
+  }
+
+  printf("movements        %lu (depart %lu, arrive %lu, lead busy %lu, bail out %lu,"
+         " pipeline %lu)\n",
+         st.movements, st.byType[SimYard::DEPART], st.byType[SimYard::ARRIVE],
+         st.byType[SimYard::LEAD_BUSY], st.byType[SimYard::BAIL_OUT],
+         st.byType[SimYard::PIPELINE]);
+  printf("failures         %lu\n", st.failures + journalFailures + bootFailures + panelFailures +
+                                    healthFailures + linkFailures);
+  printf("yards            at most %u busy at once\n", st.mostBusy);
+  for (uint8_t y = 0; y < YARD_COUNT; y++)
+    printf("  yard %u         %lu movements, worst reaction %.3f ms\n", y + 1,
+           st.byYard[y], st.reactUs[y] / 1e3);
+  printf("boot             sensors %.2f ms, state machine %.2f ms, panel ", bootSensorsUs / 1e3,
+         bootControlUs / 1e3);
+  if (bootDisplayUs) printf("%.2f ms\n", bootDisplayUs / 1e3);
+  else printf("missing\n");
+  printf("train gauge      %lu measured, worst speed %.2f%%, length %.2f%% off\n",
+         st.trains, st.worstSpeedErr, st.worstLengthErr);
+  printf("worst release    %.3f ms after the train cleared\n", st.worstReleaseUs / 1e3);
+  printf("route setup      %lu routes, %lu turnouts thrown, %lu moved nothing,"
+         " %.2f s power off each (fixed %.0f s)\n", st.routes, st.thrown, st.unmoved,
+         st.routes ? st.setupS / st.routes : 0.0, SimYard::TORTI_TIMER_S);
+  const MotorLink &drv = motorDriver.link();
+  printf("motor link       panel %lu frames, %lu resent, %lu bad; driver %lu frames,"
+         " %lu resent, %lu bad\n", motorLink.framesSent(), motorLink.resent(),
+         motorLink.badFrames(), drv.framesSent(), drv.resent(), drv.badFrames());
+  printf("journal          %lu records, worst byte %lu writes\n", journalRecords,
+         (unsigned long)wear);
+  printf("track holds      %lu, %lu fitted to the train, %.1f s lead time recovered"
+         " (%.1f s each)\n", st.holds, st.fittedHolds,
+         st.recoveredS, st.holds ? st.recoveredS / st.holds : 0.0);
+  printf("worst occupied   %.3f ms after the lead was blocked\n", st.worstOccupiedUs / 1e3);
+  printf("simulated        %.1f s in %.3f s wall (%.0fx real time)\n",
+         simSeconds, wall, wall > 0 ? simSeconds / wall : 0.0);
+  printf("throughput       %.0f movements/s, %.0f loops/s\n",
+         wall > 0 ? st.movements / wall : 0.0, wall > 0 ? loops / wall : 0.0);
+  printf("sensor health    %lu chatter, %lu stuck blocked, %lu stuck clear flagged;"
+         " %lu glitches, windows %.1f-%.1f ms\n", st.flagged[SENSOR_CHATTER],
+         st.flagged[SENSOR_STUCK_BLOCKED], st.flagged[SENSOR_STUCK_CLEAR], glitches,
+         windowMin / 1e3, windowMax / 1e3);
+  printf("i2c              %lu bytes in %lu transfers\n", Wire.bytes, Wire.transactions);
+  printf("panel            %lu pages sent, %lu unchanged; %lu screens checked against"
+         " its RAM\n", panel.pagesSent(), panel.pagesSkipped(), panelChecks);
+
+  if (telemetryOut) fclose(telemetryOut);
+  trace.close();
+  return st.failures + journalFailures + bootFailures + panelFailures + healthFailures +
+         linkFailures ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+//---------------------------Trace Replay------------------------------------
+// Feeds a recorded trace (include/sim/Trace.h) through the sketch's own
+// edge capture, debounce and PairBank on simulated time, for all four
+// yards at once, and compares the PassBy events that come out with the
+// MARK records in the trace.  Every debounced edge the sketch reports is
+// also run through PairState, one pair at a time, and the two must agree
+// on every pair after every tick.
+//
+// Only the sensor task runs, once per simulated millisecond as it is
+// scheduled on the board; the PassBy flags are cleared after every tick
+// the way the state machine consumes them.  Raw edges are applied at
+// their exact recorded times, so each one is captured with the same
+// timestamp the pin change ISR gave it on the layout.
+//
+// Reported:
+//   latency    - PassBy reported minus the first transition of the edge
+//                that completed it (debounce plus task phase)
+//   missed     - MARK with no PassBy of that pair and direction nearby
+//   false      - PassBy with no MARK nearby (only if the trace has marks)
+//   kernel     - ticks where PairBank and PairState disagreed (needs
+//                TELEMETRY_LEVEL 3 for the edge records)
+//   throughput - raw edges replayed per wall second
+//---------------------------------------------------------------------------
+
+#include "Hal.h"
+#include "EdgeCapture.h"
+#include "Telemetry.h"
+#include "Yard.h"
+#include "SensorPair.h"
+#include "sim/SimYard.h"
+#include "sim/Trace.h"
+#include <chrono>
+
+void setup();
+void readAllSens();
+
+static const uint64_t TICK_US  = 1000;      //---sensor task period
+static const uint64_t IDLE_US  = 50000;     //---quiet this long, skip ahead
+static const uint64_t MATCH_US = 1000000;   //---mark to PassBy tolerance
+
+struct Detection { uint64_t edgeUs, reportUs; uint8_t pair, direction; bool matched; };
+struct Mark      { uint64_t us; uint8_t pair, direction; bool matched; };
+
+static std::vector<Detection> detections;
+static uint8_t rec[Telemetry::RECORD_SIZE];
+static uint8_t recLen = 0;
+
+static PairState     shadow[PAIR_COUNT];     //---PairState, fed from EDGE records
+static uint8_t       shadowLevels[SENSOR_COUNT];
+static unsigned long shadowEdges, shadowMismatches;
+
+static void shadowEdge(uint8_t sensor, uint8_t level)
+{
+  if (sensor >= SENSOR_COUNT) return;
+  uint8_t in = sensor & ~1;
+  shadowLevels[sensor] = level;
+  shadow[in / 2].update(shadowLevels[in], shadowLevels[in + 1]);
+  shadowEdges++;
+}
+
+static void shadowCheck()
+{
+  for (uint8_t p = 0; p < PAIR_COUNT; p++)
+  {
+    const PairState &s = shadow[p];
+    if (s.busy != pairBank.busy(p) || s.direction != pairBank.direction(p) ||
+        s.lastDirection != pairBank.lastDirection(p) || s.passBy != pairBank.passBy(p))
+    {
+      shadowMismatches++;
+      return;
+    }
+  }
+}
+
+//---PASSBY records are the detections, EDGE records feed the PairState
+//   shadow; simNowUs() is when it was reported
+static void onSerial(uint8_t c)
+{
+  if (recLen == 0 && c != Telemetry::SYNC) return;
+  rec[recLen++] = c;
+  if (recLen < sizeof(rec)) return;
+  recLen = 0;
+
+  uint8_t check = 0;
+  for (int i = 1; i < Telemetry::RECORD_SIZE - 1; i++) check ^= rec[i];
+  if (check != rec[Telemetry::RECORD_SIZE - 1]) return;
+  if (rec[1] == TLM_EDGE) shadowEdge(rec[3], rec[4]);
+  if (rec[1] != TLM_PASSBY) return;
+
+  uint32_t edgeUs = rec[7] | (rec[8] << 8) | ((uint32_t)rec[9] << 16) |
+                    ((uint32_t)rec[10] << 24);
+  uint64_t now    = simNowUs();
+  uint32_t late   = (uint32_t)micros() - edgeUs;        //---wrap safe
+  Detection d = { now - late, now, rec[3], rec[4], false };
+  detections.push_back(d);
+}
+
+static void advanceTo(uint64_t us)
+{
+  uint64_t now = simNowUs();
+  if (us > now) simAdvanceUs((unsigned long)(us - now));
+}
+
+static void sensorTick(uint64_t us)
+{
+  advanceTo(us);
+  readAllSens();
+  shadowCheck();
+  pairBank.clearPassBy(0xFF);
+  for (uint8_t p = 0; p < PAIR_COUNT; p++) shadow[p].passBy = false;
+}
+
+static const char *pairName(uint8_t p)
+{
+  static char name[12];
+  snprintf(name, sizeof(name), "%u %s", p / 2 + 1, p & 1 ? "rev " : "main");
+  return name;
+}
+static const char *dirName(uint8_t d)  { return d == 2 ? "OUTBOUND" : "INBOUND "; }
+
+int traceReplay(const char *path, unsigned long repeat, bool verbose)
+{
+  std::vector<TraceRecord> trace;
+  if (!traceLoad(path, trace))
+  {
+    fprintf(stderr, "%s: not a readable trace\n", path);
+    return 2;
+  }
+  if (repeat == 0) repeat = 1;
+
+  simReset();
+  Serial.onWrite(onSerial);
+  setup();
+  detections.clear();
+  for (uint8_t p = 0; p < PAIR_COUNT; p++) shadow[p].reset();
+  memset(shadowLevels, HIGH, sizeof(shadowLevels));
+  shadowEdges = shadowMismatches = 0;
+
+  std::vector<Mark> marks;
+  unsigned long edges = 0;
+  uint64_t start = simNowUs(), base = start;
+  uint64_t tick = base + TICK_US, lastEdge = base, traceEnd = base;
+  auto wallStart = std::chrono::steady_clock::now();
+
+  for (unsigned long pass = 0; pass < repeat; pass++)
+  {
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      const TraceRecord &r = trace[i];
+      uint64_t t = base + r.us;
+
+      //---nothing pending for a while: jump the tick, keeping its phase
+      if (tick > lastEdge + IDLE_US && t > tick + IDLE_US)
+        tick += (t - IDLE_US - tick) / TICK_US * TICK_US;
+      while (tick <= t)
+      {
+        sensorTick(tick);
+        tick += TICK_US;
+      }
+      advanceTo(t);
+
+      if (r.kind == TraceRecord::EDGE)
+      {
+        if (r.id < SENSOR_COUNT && sensorPin(r.id) != NO_PIN)
+          simSetPin(sensorPin(r.id), r.value);
+        lastEdge = t;
+        edges++;
+      }
+      else
+      {
+        Mark m = { t, r.id, r.value, false };
+        marks.push_back(m);
+      }
+      traceEnd = t;
+    }
+    base = traceEnd + MATCH_US;          //---next pass starts a second later
+  }
+  while (tick <= lastEdge + IDLE_US)
+  {
+    sensorTick(tick);
+    tick += TICK_US;
+  }
+
+  double wall = std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - wallStart).count();
+
+  //---pair each PassBy with the earliest unclaimed mark within MATCH_US
+  unsigned long matched = 0;
+  uint64_t latMin = UINT64_MAX, latMax = 0, latSum = 0;
+  for (size_t i = 0; i < detections.size(); i++)
+  {
+    Detection &d = detections[i];
+    uint64_t lat = d.reportUs - d.edgeUs;
+    if (lat < latMin) latMin = lat;
+    if (lat > latMax) latMax = lat;
+    latSum += lat;
+
+    for (size_t m = 0; m < marks.size(); m++)
+    {
+      Mark &k = marks[m];
+      if (k.matched || k.pair != d.pair || k.direction != d.direction) continue;
+      uint64_t apart = k.us > d.edgeUs ? k.us - d.edgeUs : d.edgeUs - k.us;
+      if (apart > MATCH_US) continue;
+      k.matched = d.matched = true;
+      matched++;
+      break;
+    }
+    if (verbose)
+      printf("%12.6fs  PassBy %s %s  %.3f ms%s\n", (d.edgeUs - start) / 1e6,
+             pairName(d.pair), dirName(d.direction), lat / 1e3,
+             marks.empty() || d.matched ? "" : "  FALSE");
+  }
+  if (verbose)
+    for (size_t m = 0; m < marks.size(); m++)
+      if (!marks[m].matched)
+        printf("%12.6fs  MARK   %s %s  MISSED\n", (marks[m].us - start) / 1e6,
+               pairName(marks[m].pair), dirName(marks[m].direction));
+
+  unsigned long missed = marks.size() - matched;
+  unsigned long falsePassBy = marks.empty() ? 0 : detections.size() - matched;
+  double simSeconds = (traceEnd - start) / 1e6;
+
+  printf("trace            %s, %lu edges, %lu marks, %.1f s (x%lu)\n", path,
+         edges, (unsigned long)marks.size(), simSeconds, repeat);
+  printf("passby           %lu reported", (unsigned long)detections.size());
+  if (marks.empty()) printf(", no marks to check against\n");
+  else printf(", %lu expected, %lu missed, %lu false\n",
+              (unsigned long)marks.size(), missed, falsePassBy);
+  if (!detections.empty())
+    printf("latency          min %.3f  mean %.3f  max %.3f ms after the clearing edge\n",
+           latMin / 1e3, latSum / 1e3 / detections.size(), latMax / 1e3);
+  if (shadowEdges)
+    printf("kernel           %lu edges checked against PairState, %lu ticks differ\n",
+           shadowEdges, shadowMismatches);
+  printf("overruns         raw %lu, edge %lu\n",
+         edgeCapture.rawOverruns(), edgeCapture.edgeOverruns());
+  printf("throughput       %.0f edges/s, %.0fx real time\n",
+         wall > 0 ? edges / wall : 0.0, wall > 0 ? simSeconds / wall : 0.0);
+
+  return missed || falsePassBy || shadowMismatches ? 1 : 0;
+}
@@ -0,0 +1,490 @@
+//---------------------------Simulated Yard----------------------------------
+// See include/sim/SimYard.h.  Only built in the native environment.
+//---------------------------------------------------------------------------
+
+#include "sim/SimYard.h"
+#include "KnobEncoder.h"
+#include <algorithm>
+#include <math.h>
+
+//---timings of the sketch under test (src/main.cpp)
+static const uint64_t MS = 1000ULL;
+static const double   GAUGE_PERCENT = 5;   //---speed/length tolerance, chatter
+
+const char *SimStates::name(uint8_t s)
+{
+  static const char *names[] = {"HOUSEKEEP", "STAND_BY", "TRACK_SETUP",
+                                "TRACK_ACTIVE", "OCCUPIED"};
+  return s < 5 ? names[s] : "NONE";
+}
+
+//---where the knob is over all yards' tracks, as readEncoder() counts
+static int knobPosition(uint8_t yard, uint8_t track)
+{
+  int pos = 0;
+  for (uint8_t y = 0; y < yard; y++)
+    pos += yardInfo[y].lastTrack - yardInfo[y].firstTrack + 1;
+  return pos + track - yardInfo[yard].firstTrack;
+}
+
+SimYard::SimYard(uint32_t seed, unsigned long stepUs)
+  : rng(seed ? seed : 1),
+    reactUs(20 * MS + 2 * stepUs)    //---debounce, task periods and a step
+{
+  for (uint8_t y = 0; y < YARD_COUNT; y++) plan(y);
+}
+
+uint32_t SimYard::rnd(uint32_t lo, uint32_t hi)
+{
+  rng ^= rng << 13;                  //---xorshift32, repeatable per seed
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return lo + rng % (hi - lo + 1);
+}
+
+//---------------------------action queue------------------------------------
+void SimYard::at(uint64_t us, uint8_t yard, uint8_t pin, uint8_t level)
+{
+  Action a = { us, PIN, pin, level, yard };
+  actions.insert(std::upper_bound(actions.begin(), actions.end(), a,
+                   [](const Action &x, const Action &y) { return x.us < y.us; }), a);
+  lanes[yard].pending++;
+}
+
+//---expected PassBy, only goes into a recorded trace
+void SimYard::markAt(uint64_t us, uint8_t yard, uint8_t pair, uint8_t direction)
+{
+  Action a = { us, MARK, pair, direction, yard };
+  actions.insert(std::upper_bound(actions.begin(), actions.end(), a,
+                   [](const Action &x, const Action &y) { return x.us < y.us; }), a);
+  lanes[yard].pending++;
+}
+
+uint64_t SimYard::nextActionUs() const
+{
+  return actions.empty() ? UINT64_MAX : actions.front().us;
+}
+
+void SimYard::fireDue()
+{
+  while (!actions.empty() && actions.front().us <= simNowUs())
+  {
+    Action a = actions.front();
+    actions.erase(actions.begin());
+    lanes[a.yard].pending--;
+    if (a.kind == PIN)
+    {
+      simSetPin(a.pin, a.level);
+      if (trace) recordEdge(a.pin, a.level);
+    }
+    else if (trace) trace->mark(simNowUs(), a.pin, a.level);
+  }
+}
+
+void SimYard::recordEdge(uint8_t pin, uint8_t level)
+{
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+    if (sensorPin(i) == pin) trace->edge(simNowUs(), i, level);
+}
+
+//---One sensor edge with optical/contact chatter on about half of them:
+//   the level flickers back once before settling, well inside the 5ms
+//   debounce.  The edge the sketch should see is the final settle.
+void SimYard::edge(uint64_t us, uint8_t yard, uint8_t sensor, uint8_t level)
+{
+  Lane &l = lanes[yard];
+  uint8_t pin = sensorPin(yard * SENSORS_PER_YARD + sensor);
+  at(us, yard, pin, level);
+  if (rnd(0, 1))
+  {
+    at(us + rnd(100, 800), yard, pin, !level);
+    us += rnd(900, 2500);
+    at(us, yard, pin, level);
+  }
+  if (!l.firstEdgeUs) l.firstEdgeUs = us;
+  if (us > l.lastEdgeUs) l.lastEdgeUs = us;
+}
+
+//---A whole train through one pair: the first sensor blocks, then the
+//   second, then they clear in the same order.  Active low.
+void SimYard::trainPass(uint64_t t0, uint8_t yard, bool rev, bool outbound)
+{
+  uint8_t inSens  = rev ? REV_IN  : MAIN_IN;
+  uint8_t outSens = rev ? REV_OUT : MAIN_OUT;
+  uint8_t first   = outbound ? outSens : inSens;
+  uint8_t second  = outbound ? inSens  : outSens;
+
+  uint64_t gap = rnd(150, 600) * MS;          //---between the two sensors
+  uint64_t len = rnd(1500, 6000) * MS;        //---train length / speed
+  uint8_t pair = yard * 2 + (rev ? PAIR_REV : PAIR_MAIN);
+  double spacing = pairSpacingMm[pair];
+  lanes[yard].speedMmS = spacing * 1e6 / gap;
+  lanes[yard].lengthMm = spacing * len / gap;
+
+  edge(t0,             yard, first,  LOW);
+  edge(t0 + gap,       yard, second, LOW);
+  edge(t0 + len,       yard, first,  HIGH);
+  edge(t0 + len + gap, yard, second, HIGH);
+  markAt(lanes[yard].lastEdgeUs, yard, pair, outbound ? 2 : 1);
+}
+
+//---------------------------movements---------------------------------------
+void SimYard::plan(uint8_t yard)
+{
+  Lane &l    = lanes[yard];
+  l.movement = (Movement)rnd(0, MOVEMENT_TYPES - 1);
+  l.idleUs   = rnd(200, 3000) * MS;           //---so the yards drift apart
+}
+
+void SimYard::start(uint8_t yard)
+{
+  Lane &l = lanes[yard];
+  uint64_t now    = simNowUs();
+  l.active        = true;
+  l.movementStart = now;
+  l.trainSent     = false;
+  l.firstEdgeUs   = l.lastEdgeUs = 0;
+  l.trackReported = l.firstReported = 0;
+  l.queued        = l.secondLeg = false;
+  l.seen.clear();
+
+  if (l.movement == LEAD_BUSY)
+  {
+    //---pulls in past the first sensor, stalls, and backs off again
+    edge(now + 10 * MS, yard, MAIN_IN, LOW);
+    edge(now + rnd(800, 3000) * MS, yard, MAIN_IN, HIGH);
+    l.trainSent = true;
+    return;
+  }
+
+  l.track      = rnd(yardInfo[yard].firstTrack, yardInfo[yard].lastTrack);
+  operatorYard = yard;
+  pressed      = false;
+  nextStepUs   = now + 10 * MS;
+}
+
+//---One detent at a time, slow enough that the knob does not accelerate,
+//   looking at where the knob is each time (another yard going back to
+//   HOUSEKEEP can move it), then the button.
+void SimYard::operate()
+{
+  if (operatorYard == NO_OPERATOR) return;
+  uint64_t now = simNowUs();
+  Lane &l = lanes[operatorYard];
+  if (now < nextStepUs) return;
+
+  if (pressed)
+  {
+    //---button is back up; PIPELINE goes on to queue its second track,
+    //   BAIL_OUT still needs the switch
+    if (l.movement == PIPELINE && !l.queued)
+    {
+      l.queued     = true;
+      l.firstTrack = l.track;
+      l.track      = rnd(yardInfo[operatorYard].firstTrack, yardInfo[operatorYard].lastTrack);
+      pressed      = false;
+      nextStepUs   = now + 150 * MS;
+    }
+    else if (l.movement != BAIL_OUT) operatorYard = NO_OPERATOR;
+    return;
+  }
+
+  int here = knobPosition(focusYard, yards[focusYard].tracknumChoice);
+  int want = knobPosition(operatorYard, l.track);
+  if (here != want)
+  {
+    knob.simTurn(want > here ? 1 : -1);
+    nextStepUs = now + 150 * MS;
+    return;
+  }
+  at(now + 50 * MS,  operatorYard, SimPins::knobSwitch, LOW);
+  at(now + 150 * MS, operatorYard, SimPins::knobSwitch, HIGH);
+  pressed    = true;
+  nextStepUs = now + 200 * MS;
+}
+
+void SimYard::observe()
+{
+  uint64_t now = simNowUs();
+  unsigned busy = 0;
+
+  operate();
+  for (uint8_t y = 0; y < YARD_COUNT; y++)
+  {
+    Lane &l = lanes[y];
+    if (!l.active)
+    {
+      if (l.current == SimStates::STAND_BY && l.pending == 0 &&
+          now - l.currentSince >= l.idleUs &&
+          (l.movement == LEAD_BUSY || operatorYard == NO_OPERATOR))
+      {
+        start(y);
+      }
+      if (!l.active) continue;
+    }
+    busy++;
+
+    //---PIPELINE: the queued route has started, its own train next
+    if (l.movement == PIPELINE && l.trainSent && !l.secondLeg &&
+        l.current == SimStates::TRACK_SETUP)
+    {
+      l.secondLeg = true;
+      l.trainSent = false;
+    }
+
+    if (!l.trainSent && l.current == SimStates::TRACK_ACTIVE)
+    {
+      l.trainSent = true;
+      if (l.movement == DEPART || l.movement == PIPELINE)
+        trainPass(now + 1000 * MS, y, yardInfo[y].revLoop && rnd(0, 1), true);
+      else if (l.movement == ARRIVE) trainPass(now + 1000 * MS, y, false, false);
+      else
+      {
+        at(now + 2000 * MS, y, SimPins::bailOut, LOW);
+        at(now + 2100 * MS, y, SimPins::bailOut, HIGH);
+        l.firstEdgeUs = l.lastEdgeUs = now + 2000 * MS;
+      }
+    }
+
+    if (!l.seen.empty() && l.seen.back().state == SimStates::STAND_BY &&
+        l.pending == 0)
+    {
+      finish(y);
+    }
+    else if (now - l.movementStart > 60000 * MS)
+    {
+      l.seen.push_back({SimStates::NONE, now});      //---mark the timeout
+      actions.erase(std::remove_if(actions.begin(), actions.end(),
+                      [y](const Action &a) { return a.yard == y; }), actions.end());
+      l.pending = 0;
+      finish(y);
+    }
+  }
+  if (busy > st.mostBusy) st.mostBusy = busy;
+}
+
+void SimYard::finish(uint8_t y)
+{
+  static const uint8_t route[] = { SimStates::TRACK_SETUP, SimStates::TRACK_ACTIVE,
+                                   SimStates::HOUSEKEEP, SimStates::STAND_BY };
+  static const uint8_t busy[]  = { SimStates::OCCUPIED, SimStates::HOUSEKEEP,
+                                   SimStates::STAND_BY };
+  static const uint8_t pipeline[] = { SimStates::TRACK_SETUP, SimStates::TRACK_ACTIVE,
+                                      SimStates::HOUSEKEEP, SimStates::TRACK_SETUP,
+                                      SimStates::TRACK_ACTIVE, SimStates::HOUSEKEEP,
+                                      SimStates::STAND_BY };
+  Lane &l = lanes[y];
+  std::vector<Seen> &seen = l.seen;
+  const uint8_t *want = l.movement == LEAD_BUSY ? busy :
+                        l.movement == PIPELINE ? pipeline : route;
+  size_t wantLen      = l.movement == LEAD_BUSY ? sizeof(busy) :
+                        l.movement == PIPELINE ? sizeof(pipeline) : sizeof(route);
+
+  bool ok = seen.size() == wantLen;
+  for (size_t i = 0; ok && i < wantLen; i++) ok = seen[i].state == want[i];
+
+  const char *why = ok ? 0 : "wrong state sequence";
+  if (ok && l.movement != LEAD_BUSY && l.trackReported != l.track)
+  {
+    ok = false;
+    why = "wrong track";
+  }
+  if (ok && l.movement == PIPELINE && l.firstReported != l.firstTrack)
+  {
+    ok = false;
+    why = "wrong first track";
+  }
+  if (ok)
+  {
+    uint64_t react;
+    switch (l.movement)
+    {
+      case DEPART:
+      case BAIL_OUT:
+        react = seen[2].us - l.lastEdgeUs;
+        if (l.movement == DEPART && react > st.worstReleaseUs) st.worstReleaseUs = react;
+        if (seen[2].us < l.lastEdgeUs || react > reactUs) { ok = false; why = "late release"; }
+        break;
+      case ARRIVE:
+      {
+        //---the tail passed the main pair at lastEdgeUs; it is in the
+        //   track trackDistanceMm() later at the speed the train ran
+        double   inUs  = trackDistanceMm(y, l.track) * 1e6 / l.speedMmS;
+        double   fitUs = clearanceMs(y, l.track, (uint16_t)l.speedMmS) * 1e3;
+        uint64_t rel   = seen[2].us - l.lastEdgeUs;
+        if (seen[2].us < l.lastEdgeUs || rel < inUs) { ok = false; why = "released before the train was in"; }
+        else if (rel > fitUs * (1 + GAUGE_PERCENT / 100) + reactUs) { ok = false; why = "late release"; }
+        break;
+      }
+      case PIPELINE:
+        //---the queued route starts straight from HOUSEKEEP
+        react = seen[3].us - seen[2].us;
+        if (react > reactUs) { ok = false; why = "queued route late"; }
+        react = seen[5].us - l.lastEdgeUs;
+        if (seen[5].us < l.lastEdgeUs || react > reactUs) { ok = false; why = "late release"; }
+        break;
+      case LEAD_BUSY:
+        react = seen[0].us - l.firstEdgeUs;
+        if (react > st.worstOccupiedUs) st.worstOccupiedUs = react;
+        if (seen[0].us < l.firstEdgeUs || react > reactUs) { ok = false; why = "late OCCUPIED"; }
+        break;
+      default:
+        break;
+    }
+  }
+
+  static const char *names[] = {"DEPART", "ARRIVE", "LEAD_BUSY", "BAIL_OUT", "PIPELINE"};
+  st.movements++;
+  st.byYard[y]++;
+  if (l.movement < MOVEMENT_TYPES) st.byType[l.movement]++;
+  if (!ok) st.failures++;
+
+  if (verbose || !ok)
+  {
+    printf("%10.3fs  yard %u  %-9s track %2u  %s", l.movementStart / 1e6, y + 1,
+           names[l.movement], l.movement == LEAD_BUSY ? 0 : l.track, ok ? "ok  " : "FAIL");
+    for (size_t i = 0; i < seen.size(); i++) printf(" %s", SimStates::name(seen[i].state));
+    if (!ok) printf("  (%s)", why);
+    printf("\n");
+  }
+
+  if (operatorYard == y) operatorYard = NO_OPERATOR;
+  l.active = false;
+  seen.clear();
+  plan(y);
+}
+
+//---rail power is going on after a TRACK_SETUP of setupUs: the turnouts
+//   must be home and set for the track the yard reported
+void SimYard::checkRoute(uint8_t y, uint64_t setupUs)
+{
+  Lane &l = lanes[y];
+  Route r;
+  const char *why = 0;
+  if (!trackRoute(y, l.trackReported, r)) why = "no route for the track";
+  else if ((l.pointsKnown & r.uses) != r.uses || (l.points & r.uses) != r.reverse)
+    why = "turnouts not set for the route";
+  else if (simNowUs() - l.lastThrowUs < tortiThrowMs * 1000ULL && l.lastThrowUs > l.currentSince)
+    why = "rail power on before the turnouts were home";
+
+  st.routes++;
+  st.setupS += setupUs / 1e6;
+  if (l.lastThrowUs < l.currentSince) st.unmoved++;
+  if (why)
+  {
+    st.failures++;
+    printf("%12.6fs  yard %u  track %u  %s\n", simNowUs() / 1e6, y + 1,
+           l.trackReported, why);
+  }
+}
+
+//---------------------------motor driver------------------------------------
+//  The driver's outputs (MotorDriver.h), as the MotorMan boards and the
+//  power relays would see them.
+void SimYard::onMotor(uint8_t y, uint8_t turnout, bool reverse)
+{
+  if (y >= YARD_COUNT) return;
+  Lane &l = lanes[y];
+  uint8_t b = 1 << turnout;
+  l.points       = reverse ? l.points | b : l.points & ~b;
+  l.pointsKnown |= b;
+  l.lastThrowUs  = simNowUs();
+  st.thrown++;
+  if (l.lastThrowUs - l.batchUs > 1000) { l.batchUs = l.lastThrowUs; l.batch = 0; }
+  const char *why = 0;
+  if (++l.batch > tortiPerStep) why = "too many turnout motors started together";
+  if (l.power) why = "turnout thrown with rail power on";
+  if (why)
+  {
+    st.failures++;
+    printf("%12.6fs  yard %u  %s\n", simNowUs() / 1e6, y + 1, why);
+  }
+}
+
+//---a driver reset clears the shift registers: every relay drops and
+//   every turnout is driven to normal, those that were reverse moving
+void SimYard::driverReset()
+{
+  for (uint8_t y = 0; y < YARD_COUNT; y++)
+  {
+    Lane &l = lanes[y];
+    l.power = false;
+    if (l.points) l.lastThrowUs = simNowUs();
+    l.points      = 0;
+    l.pointsKnown = 0xFF;
+  }
+}
+
+void SimYard::onPower(uint8_t y, bool on)
+{
+  if (y >= YARD_COUNT) return;
+  Lane &l = lanes[y];
+  l.power = on;
+  if (on && l.pointsKnown && simNowUs() - l.lastThrowUs < tortiThrowMs * 1000ULL)
+  {
+    st.failures++;
+    printf("%12.6fs  yard %u  rail power on with a turnout still moving\n",
+           simNowUs() / 1e6, y + 1);
+  }
+}
+
+//---------------------------telemetry tap-----------------------------------
+//  Records are decoded as they are written, so simNowUs() is the time the
+//  sketch emitted them.
+void SimYard::onTelemetry(uint8_t c)
+{
+  if (recLen == 0 && c != Telemetry::SYNC) return;
+  rec[recLen++] = c;
+  if (recLen < sizeof(rec)) return;
+  recLen = 0;
+
+  uint8_t check = 0;
+  for (int i = 1; i < Telemetry::RECORD_SIZE - 1; i++) check ^= rec[i];
+  if (check != rec[Telemetry::RECORD_SIZE - 1]) return;
+
+  uint8_t type = rec[1];
+  if (type == TLM_STATE && rec[3] < YARD_COUNT)      //---id yard, val8 to, val16 from
+  {
+    Lane &l = lanes[rec[3]];
+    if (rec[5] == SimStates::TRACK_SETUP) checkRoute(rec[3], simNowUs() - l.currentSince);
+    l.current      = rec[4];
+    l.currentSince = simNowUs();
+    if (l.active) l.seen.push_back({l.current, l.currentSince});
+  }
+  else if (type == TLM_TRACK && rec[3] < YARD_COUNT)
+  {
+    Lane &l = lanes[rec[3]];
+    if (!l.firstReported) l.firstReported = rec[4];
+    l.trackReported = rec[4];
+  }
+  else if (type == TLM_REACTION && rec[3] < YARD_COUNT)
+  {
+    unsigned long us = rec[5] | (rec[6] << 8);
+    if (us > st.reactUs[rec[3]]) st.reactUs[rec[3]] = us;
+  }
+  else if (type == TLM_HEALTH && rec[4] == HEALTH_CONDITION && rec[5] < 4)
+  {
+    st.flagged[rec[5]]++;
+  }
+  else if (type == TLM_HOLD)              //---id yard, val8 fitted, val16 10ms
+  {
+    st.holds++;
+    st.fittedHolds += rec[4];
+    double held = (rec[5] | (rec[6] << 8)) / 100.0;
+    if (held < TRAIN_TIMER_S) st.recoveredS += TRAIN_TIMER_S - held;
+  }
+  else if (type == TLM_TRAIN && rec[3] < YARD_COUNT * 2)   //---id pair, val8 which
+  {
+    Lane &l = lanes[rec[3] / 2];
+    double value  = rec[5] | (rec[6] << 8);
+    double expect = rec[4] ? l.lengthMm : l.speedMmS;
+    double err    = expect > 0 ? fabs(value - expect) * 100 / expect : 100;
+    double &worst = rec[4] ? st.worstLengthErr : st.worstSpeedErr;
+    if (err > worst) worst = err;
+    if (rec[4]) st.trains++;
+    if (err > GAUGE_PERCENT) st.failures++;
+    if (verbose || err > GAUGE_PERCENT)
+      printf("%12.6fs  yard %u train %s %.0f, expected %.0f\n", simNowUs() / 1e6,
+             rec[3] / 2 + 1, rec[4] ? "length mm" : "speed mm/s", value, expect);
+  }
+}
@@ -0,0 +1,112 @@
+//---------------------------Sensor Traces-----------------------------------
+// See include/sim/Trace.h for the file format.  Only built in the native
+// environment.
+//---------------------------------------------------------------------------
+
+#include "sim/Trace.h"
+#include <string.h>
+
+static const char MAGIC[4] = {'B', 'O', 'T', 'R'};
+
+bool TraceWriter::open(const char *path)
+{
+  close();
+  f = fopen(path, "wb");
+  if (!f) return false;
+  uint8_t header[8] = {'B', 'O', 'T', 'R', VERSION, SENSORS, 0, 0};
+  fwrite(header, 1, sizeof(header), f);
+  started = false;
+  return true;
+}
+
+//---The first record fixes time zero, so a trace always starts at 0us
+//   whatever the simulated or micros() time was when recording began.
+void TraceWriter::put(uint64_t us, uint8_t tag)
+{
+  if (!f) return;
+  if (!started)
+  {
+    startUs = lastUs = us;
+    started = true;
+  }
+  if (us < lastUs) us = lastUs;          //---never go backwards
+  uint64_t v = ((us - lastUs) << 6) | (tag & 0x3F);
+  lastUs = us;
+  do
+  {
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    fputc(v ? (b | 0x80) : b, f);
+  } while (v);
+}
+
+void TraceWriter::edge(uint64_t us, uint8_t sensor, uint8_t level)
+{
+  put(us, ((sensor & (SENSORS - 1)) << 1) | (level ? 1 : 0));
+}
+
+void TraceWriter::mark(uint64_t us, uint8_t pair, uint8_t direction)
+{
+  put(us, 32 + ((pair & (PAIRS - 1)) << 1) + (direction == 2 ? 1 : 0));
+}
+
+void TraceWriter::close()
+{
+  if (f) fclose(f);
+  f = 0;
+}
+
+bool traceLoad(const char *path, std::vector<TraceRecord> &out)
+{
+  FILE *in = fopen(path, "rb");
+  if (!in) return false;
+
+  uint8_t header[8];
+  if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+      memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+      header[4] < 1 || header[4] > TraceWriter::VERSION)
+  {
+    fclose(in);
+    return false;
+  }
+
+  //---version 1: 4 bit tags, edges 0-7, marks 8-11
+  unsigned tagBits = header[4] == 1 ? 4 : 6;
+  uint8_t  marks   = header[4] == 1 ? 8 : 32;
+  uint8_t  ids     = header[4] == 1 ? 2 : 8;
+
+  uint64_t now = 0, v = 0;
+  unsigned shift = 0;
+  int c;
+  bool ok = true;
+  while ((c = fgetc(in)) != EOF)
+  {
+    if (shift > 63) { ok = false; break; }
+    v |= (uint64_t)(c & 0x7F) << shift;
+    shift += 7;
+    if (c & 0x80) continue;
+
+    now += v >> tagBits;
+    uint8_t tag = v & ((1 << tagBits) - 1);
+    TraceRecord r = { now, TraceRecord::EDGE, 0, 0 };
+    if (tag < marks)
+    {
+      r.id    = tag >> 1;
+      r.value = tag & 1;
+    }
+    else if (tag < marks + 2 * ids)
+    {
+      r.kind  = TraceRecord::MARK;
+      r.id    = (tag - marks) >> 1;
+      r.value = ((tag - marks) & 1) + 1;
+    }
+    else ok = false;                     //---reserved tag
+    if (!ok) break;
+    out.push_back(r);
+    v = 0;
+    shift = 0;
+  }
+  if (shift) ok = false;                 //---file ends inside a varint
+  fclose(in);
+  return ok;
+}
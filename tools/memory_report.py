@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Report where the panel firmware's flash and SRAM go, from the ELF.
+
+Reads the section and symbol tables straight from firmware.elf (no
+avr-size or avr-nm needed) and prints flash and static SRAM use, what is
+left of the Mega's 8 KB for the stack and heap, whether anything that
+allocates on the heap (String, malloc) is linked, and the largest SRAM
+symbols.  With a baseline it prints what changed.
+
+It also checks the budget: what is left after static SRAM and the heap
+the libraries are known to take (the SSD1306 frame buffer) must cover
+the stack reserve, the same sramStackBytes the compile-time budget in
+src/main.cpp keeps.  If it does not, the report says so and exits 1,
+which fails the PlatformIO build.  The yards' share is shown per yard,
+with how many more would fit in the headroom.
+
+    memory_report.py .pio/build/megaatmega2560/firmware.elf
+    memory_report.py firmware.elf --save before.json
+    memory_report.py firmware.elf --baseline before.json
+
+Run by PlatformIO after every board build (extra_scripts in
+platformio.ini); each report is compared with the previous build's.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+
+RAM_SIZE = 8192                      # ATmega2560
+SRAM_SECTIONS = (".data", ".bss", ".noinit")
+FLASH_SECTIONS = (".text", ".data")
+HEAP_HINTS = {"malloc": "malloc", "6String": "String"}
+# heap every boot takes, by a symbol that shows the library is linked
+HEAP_KNOWN = {"16Adafruit_SSD1306": ("SSD1306 frame buffer", 128 * 64 // 8)}
+STACK_RESERVE = 1536                 # sramStackBytes in src/main.cpp
+YARD_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "..", "include", "Yard.h")
+
+
+def yard_count():
+    """YARD_COUNT from include/Yard.h, or None."""
+    try:
+        with open(YARD_HEADER) as f:
+            m = re.search(r"YARD_COUNT\s*=\s*(\d+)", f.read())
+        return int(m.group(1)) if m else None
+    except OSError:
+        return None
+
+
+def read_elf(path):
+    """Returns ({section: size}, [(name, size, section)]) for an ELF file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        raise SystemExit("%s: not an ELF file" % path)
+    is64 = data[4] == 2
+    end = "<" if data[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x3A)
+        sh_fmt, sym_fmt = end + "IIQQQQIIQQ", end + "IBBHQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x2E)
+        sh_fmt, sym_fmt = end + "IIIIIIIIII", end + "IIIBBH"
+
+    sections = []
+    for i in range(shnum):
+        sh = struct.unpack_from(sh_fmt, data, shoff + i * shentsize)
+        # name, type, flags, addr, offset, size, link, info, align, entsize
+        sections.append(sh)
+
+    def cstr(off):
+        return data[off:data.index(b"\0", off)].decode("ascii", "replace")
+
+    strtab_off = sections[shstrndx][4]
+    names = [cstr(strtab_off + s[0]) for s in sections]
+    sizes = {}
+    for n, s in zip(names, sections):
+        if n:
+            sizes[n] = sizes.get(n, 0) + s[5]
+
+    symbols = []
+    for s in sections:
+        if s[1] != 2:                # SHT_SYMTAB
+            continue
+        str_off = sections[s[6]][4]
+        entsize = s[9]
+        for off in range(s[4], s[4] + s[5], entsize):
+            if is64:
+                name, info, _, shndx, _, size = struct.unpack_from(sym_fmt, data, off)
+            else:
+                name, _, size, info, _, shndx = struct.unpack_from(sym_fmt, data, off)
+            if 0 < shndx < len(names):
+                symbols.append((cstr(str_off + name), size, names[shndx]))
+    return sizes, symbols
+
+
+def summarize(path, top, reserve=STACK_RESERVE):
+    sizes, symbols = read_elf(path)
+    sram = sum(sizes.get(s, 0) for s in SRAM_SECTIONS)
+    known = {}
+    for hint, (label, size) in HEAP_KNOWN.items():
+        if any(hint in name for name, _, _ in symbols):
+            known[label] = size
+    yards = next((size for name, size, sec in symbols
+                  if name == "yards" and sec in SRAM_SECTIONS), 0)
+    summary = {
+        "flash": sum(sizes.get(s, 0) for s in FLASH_SECTIONS),
+        "data": sizes.get(".data", 0),
+        "bss": sizes.get(".bss", 0) + sizes.get(".noinit", 0),
+        "sram": sram,
+        "free": RAM_SIZE - sram,
+        "heapKnown": known,
+        "reserve": reserve,
+        "headroom": RAM_SIZE - sram - sum(known.values()) - reserve,
+        "yards": yards,
+        "yardCount": yard_count(),
+        "heap": sorted({label for name, _, _ in symbols
+                        for hint, label in HEAP_HINTS.items() if hint in name}),
+        "symbols": {},
+    }
+    ram_syms = [(size, name) for name, size, sec in symbols
+                if sec in SRAM_SECTIONS and size]
+    for size, name in sorted(ram_syms, reverse=True)[:top]:
+        summary["symbols"][name] = size
+    return summary
+
+
+def delta(now, before, key):
+    if not before:
+        return ""
+    d = now[key] - before[key]
+    return "  (%+d)" % d if d else ""
+
+
+def report(summary, baseline=None):
+    b = baseline or {}
+    print("flash            %6d bytes%s" % (summary["flash"], delta(summary, b, "flash")))
+    print("sram .data       %6d bytes%s" % (summary["data"], delta(summary, b, "data")))
+    print("sram .bss        %6d bytes%s" % (summary["bss"], delta(summary, b, "bss")))
+    print("stack + heap     %6d bytes free of %d%s" % (
+        summary["free"], RAM_SIZE, delta(summary, b, "free")))
+    heap = ", ".join(summary["heap"]) or "nothing"
+    print("heap users       %s" % heap)
+    for label, size in sorted(summary.get("heapKnown", {}).items()):
+        print("  heap at boot   %6d bytes  %s" % (size, label))
+    print("stack reserve    %6d bytes" % summary["reserve"])
+    print("headroom         %6d bytes%s%s" % (
+        summary["headroom"], delta(summary, b, "headroom") if "headroom" in b else "",
+        "" if summary["headroom"] >= 0 else "  OVER BUDGET"))
+    if summary["yards"] and summary["yardCount"]:
+        per = summary["yards"] // summary["yardCount"]
+        print("yards            %d x %d bytes, room for %d more" % (
+            summary["yardCount"], per, max(0, summary["headroom"]) // per))
+    if b:
+        gone = set(b.get("heap", [])) - set(summary["heap"])
+        if gone:
+            print("                 no longer linked: %s" % ", ".join(sorted(gone)))
+    print("largest sram symbols:")
+    for name, size in sorted(summary["symbols"].items(), key=lambda kv: -kv[1]):
+        was = b.get("symbols", {}).get(name) if b else None
+        note = "  (%+d)" % (size - was) if was is not None and was != size else ""
+        print("  %6d  %s%s" % (size, name, note))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf")
+    ap.add_argument("--baseline", metavar="JSON", help="compare with a saved report")
+    ap.add_argument("--save", metavar="JSON", help="save this report")
+    ap.add_argument("--top", type=int, default=12, help="symbols to list")
+    ap.add_argument("--reserve", type=int, default=STACK_RESERVE,
+                    help="bytes the stack needs (default %d)" % STACK_RESERVE)
+    args = ap.parse_args()
+
+    summary = summarize(args.elf, args.top, args.reserve)
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    report(summary, baseline)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(summary, f, indent=1)
+    return 0 if summary["headroom"] >= 0 else 1
+
+
+def pio_after_build(source, target, env):
+    elf = str(target[0])
+    last = os.path.join(os.path.dirname(elf), "memory_report.json")
+    baseline = None
+    if os.path.exists(last):
+        with open(last) as f:
+            baseline = json.load(f)
+    summary = summarize(elf, 12)
+    print("---- memory (tools/memory_report.py) ----")
+    report(summary, baseline)
+    with open(last, "w") as f:
+        json.dump(summary, f, indent=1)
+    if summary["headroom"] < 0:
+        print("SRAM over budget: the stack reserve is %d bytes short" % -summary["headroom"])
+        return 1
+    return 0
+
+
+try:
+    Import("env")                    # noqa: F821 - run by PlatformIO
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", pio_after_build)  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        raise SystemExit(main())
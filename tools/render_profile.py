@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Draw the panel's loop and task profile as text histograms.
+
+The sketch keeps a histogram of every task's run time and lateness and of
+each pass of loop() (include/Scheduler.h), and dumps them as TLM_HIST
+telemetry records when it is sent a 'P'.  On a live port this sends the
+'P' and waits for the dump; from a captured file it draws the last
+complete dump in it.  Each histogram gets its count, min, p50, p99 and
+max, and a bar per non-empty bucket.  The percentiles are the upper edge
+of the power-of-two bucket they fall in, never more than the max.
+
+    render_profile.py /dev/ttyACM0          # ask the panel, needs pyserial
+    render_profile.py capture.bin           # e.g. from program --profile
+    render_profile.py --only sensors --only loop capture.bin
+"""
+
+import argparse
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from telemetry_decode import (Decoder, TYPES, HIST_KINDS, HIST_BUCKETS,  # noqa: E402
+                              HIST_MIN, HIST_MAX, HIST_MISSED, HIST_END,
+                              bucket_range, hist_source, open_source)
+
+HIST = next(k for k, v in TYPES.items() if v == "HIST")
+BAR = 40
+
+
+def bucket_upper(b):
+    return None if b == HIST_BUCKETS - 1 else (1 << b) - 1
+
+
+def percentile(h, pct):
+    total = sum(h["buckets"].values())
+    if not total:
+        return 0
+    want = (total * pct + 99) // 100
+    seen = 0
+    for b in sorted(h["buckets"]):
+        seen += h["buckets"][b]
+        if seen >= want:
+            upper = bucket_upper(b)
+            if upper is None or (h["max"] is not None and upper > h["max"]):
+                return h["max"]
+            return upper
+    return h["max"]
+
+
+def collect(records):
+    """Yields each complete dump as {(source, kind): histogram}."""
+    dump, missed = {}, {}
+    for rid, val8, val16 in records:
+        if rid == HIST_END:
+            yield dump, missed
+            dump, missed = {}, {}
+            continue
+        kind, slot = val8 >> 5, val8 & 0x1F
+        if slot == HIST_MISSED:
+            missed[hist_source(rid)] = val16
+            continue
+        h = dump.setdefault((hist_source(rid), HIST_KINDS[kind] if kind < len(HIST_KINDS)
+                             else str(kind)), {"buckets": {}, "min": None, "max": None})
+        if slot == HIST_MIN:
+            h["min"] = val16
+        elif slot == HIST_MAX:
+            h["max"] = val16
+        elif slot < HIST_BUCKETS:
+            h["buckets"][slot] = val16
+
+
+def render(dump, missed, only, out=sys.stdout):
+    for (source, kind), h in dump.items():
+        if only and source not in only:
+            continue
+        total = sum(h["buckets"].values())
+        line = "%-8s %-5s  n=%-7d min %sus  p50 %sus  p99 %sus  max %sus" % (
+            source, kind, total, h["min"], percentile(h, 50), percentile(h, 99), h["max"])
+        if kind == "run" and missed.get(source):
+            line += "  missed %d" % missed[source]
+        out.write(line + "\n")
+        peak = max(h["buckets"].values()) if h["buckets"] else 0
+        for b in sorted(h["buckets"]):
+            n = h["buckets"][b]
+            bar = "#" * max(1, n * BAR // peak) if n else ""
+            out.write("  %14s |%-*s %d\n" % (bucket_range(b), BAR, bar, n))
+        out.write("\n")
+    out.write("counts are relative: a histogram halves itself when a bucket fills\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", help="serial port or captured file")
+    ap.add_argument("--only", metavar="TASK", action="append",
+                    help="draw only these tasks, or 'loop' (repeatable)")
+    ap.add_argument("--timeout", type=float, default=10.0,
+                    help="seconds to wait for a live dump")
+    args = ap.parse_args()
+
+    src, live = open_source(args.source)
+    dec = Decoder()
+
+    def records():
+        deadline = time.time() + args.timeout
+        while True:
+            data = src.read(256)
+            if not data:
+                if live and time.time() < deadline:
+                    continue
+                return
+            for _, _, _, rtype, rid, val8, val16 in dec.feed(data):
+                if rtype == HIST:
+                    yield rid, val8, val16
+
+    if live:
+        time.sleep(0.5)                  # opening the port resets the Mega
+        src.write(b"P")
+
+    last = None
+    for dump, missed in collect(records()):
+        last = (dump, missed)
+        if live:
+            break
+    if last is None:
+        sys.stderr.write("no complete profile dump in %s\n" % args.source)
+        return 1
+    render(last[0], last[1], set(args.only) if args.only else None)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
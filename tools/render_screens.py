@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""Pre-render the fixed part of every panel screen into flash bitmaps.
+
+Reads the screen layouts (the constexpr txt*/…Items/screenLayouts tables
+in src/main.cpp) and the glyphs in include/Font5x7.h, draws every
+ITEM_LABEL exactly the way Adafruit_GFX would, and writes
+include/ScreenBitmaps.h: one packed, page-ordered 128x64 frame per screen
+in the SSD1306 buffer layout, so the sketch can unpack each page of it
+straight into its page buffer and only draw the track field at run time.
+
+Packing is a byte RLE: a control byte c < 0x80 is followed by c + 1
+literal bytes, c >= 0x80 by one byte repeated (c & 0x7F) + 1 times.
+
+    render_screens.py            # regenerate if anything changed
+    render_screens.py --check    # exit 1 if the header is out of date
+
+PlatformIO runs it before every build (extra_scripts in platformio.ini).
+The generated header is committed, so a build without Python still works.
+"""
+
+import os
+import re
+import sys
+
+WIDTH, HEIGHT = 128, 64
+PAGES = HEIGHT // 8
+CELL_W, CELL_H = 6, 8
+OUTPUT = "include/ScreenBitmaps.h"
+
+
+def load_font(path):
+    with open(path) as f:
+        text = f.read()
+    body = text[text.index("font5x7[]"):]
+    body = body[:body.index("};")]
+    glyphs = re.findall(r"\{(0x[0-9A-Fa-f]{2}(?:\s*,\s*0x[0-9A-Fa-f]{2}){4})\}", body)
+    return [[int(b, 16) for b in g.split(",")] for g in glyphs]
+
+
+def load_layouts(path):
+    with open(path) as f:
+        text = f.read()
+    strings = dict(re.findall(
+        r'constexpr char (\w+)\[\]\s+PROGMEM = "((?:[^"\\]|\\.)*)";', text))
+    items = {}
+    for name, body in re.findall(
+            r"constexpr ScreenItem (\w+)\[\] PROGMEM = \{(.*?)\n\};", text, re.S):
+        rows = re.findall(
+            r"\{\s*(\w+),\s*(\d+),\s*(\d+),\s*(\d+),\s*(ITEM_\w+)\s*\}", body)
+        items[name] = [(strings.get(t), int(x), int(y), int(s), k)
+                       for t, x, y, s, k in rows]
+    table = re.search(r"constexpr ScreenLayout screenLayouts\[\w+\] PROGMEM = "
+                      r"\{(.*?)\n\};", text, re.S)
+    if not table:
+        raise SystemExit("%s: screenLayouts table not found" % path)
+    order = re.findall(r"SCREEN_LAYOUT\((\w+)\)|\{\s*0,\s*0\s*\}", table.group(1))
+    return [(n, items[n]) if n else (None, None) for n in order]
+
+
+class Frame:
+    """Adafruit_GFX text drawing, built-in font, wrap on, no background."""
+
+    def __init__(self, font):
+        self.font = font
+        self.buf = bytearray(WIDTH * PAGES)
+
+    def pixel(self, x, y):
+        if 0 <= x < WIDTH and 0 <= y < HEIGHT:
+            self.buf[x + (y // 8) * WIDTH] |= 1 << (y & 7)
+
+    def char(self, x, y, c, size):
+        code = ord(c) - 0x20
+        glyph = self.font[code] if 0 <= code < len(self.font) else [0] * 5
+        for i, line in enumerate(glyph):
+            for j in range(8):
+                if line >> j & 1:
+                    for sx in range(size):
+                        for sy in range(size):
+                            self.pixel(x + i * size + sx, y + j * size + sy)
+
+    def text(self, s, x, y, size):
+        for c in s:
+            if c == "\n":
+                x, y = 0, y + size * CELL_H
+                continue
+            if x + size * CELL_W > WIDTH:
+                x, y = 0, y + size * CELL_H
+            self.char(x, y, c, size)
+            x += size * CELL_W
+
+
+def pack(data):
+    out = bytearray()
+    i = 0
+    literal = bytearray()
+
+    def flush():
+        while literal:
+            chunk = literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:128]
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 128:
+            run += 1
+        if run >= 3:
+            flush()
+            out.append(0x80 | (run - 1))
+            out.append(data[i])
+            i += run
+        else:
+            literal.extend(data[i:i + run])
+            i += run
+    flush()
+    return out
+
+
+def unpack(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        c = data[i]
+        if c & 0x80:
+            out.extend(bytes([data[i + 1]]) * ((c & 0x7F) + 1))
+            i += 2
+        else:
+            out.extend(data[i + 1:i + 2 + c])
+            i += c + 2
+    return out
+
+
+def generate(root):
+    font = load_font(os.path.join(root, "include/Font5x7.h"))
+    layouts = load_layouts(os.path.join(root, "src/main.cpp"))
+
+    lines = [
+        "//---------------------------Pre-rendered Screens----------------------------",
+        "// GENERATED by tools/render_screens.py from the screen layouts in",
+        "// src/main.cpp and include/Font5x7.h - do not edit, rerun the script.",
+        "//",
+        "// The ITEM_LABEL items of each screen, drawn as Adafruit_GFX would and",
+        "// packed page by page (see unpackScreenPage() in ScreenLayout.h).  Entries",
+        "// follow screenLayouts[]; 0 where a screen has nothing fixed to draw.",
+        "//---------------------------------------------------------------------------",
+        "",
+        "#ifndef SCREENBITMAPS_H",
+        "#define SCREENBITMAPS_H",
+        "",
+        '#include "Hal.h"',
+        "",
+    ]
+    names = []
+    total = 0
+    for name, items in layouts:
+        if not items or not any(k == "ITEM_LABEL" for _, _, _, _, k in items):
+            names.append("0")
+            continue
+        frame = Frame(font)
+        for text, x, y, size, kind in items:
+            if kind == "ITEM_LABEL":
+                frame.text(text, x, y, size)
+        packed = pack(frame.buf)
+        assert unpack(packed) == frame.buf
+        total += len(packed)
+        sym = name.replace("Items", "Bitmap")
+        names.append(sym)
+        lines.append("//---%s, %d bytes packed" % (name, len(packed)))
+        lines.append("const uint8_t %s[] PROGMEM = {" % sym)
+        for off in range(0, len(packed), 16):
+            lines.append("  " + ",".join("0x%02X" % b for b in packed[off:off + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+    lines.append("//---%d bytes of flash for %d screens" % (total, len(names) - names.count("0")))
+    lines.append("const uint8_t * const screenBitmaps[] PROGMEM = {")
+    lines.append("  " + ", ".join(names) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif")
+    return "\n".join(lines) + "\n"
+
+
+def update(root, check=False):
+    path = os.path.join(root, OUTPUT)
+    text = generate(root)
+    old = open(path).read() if os.path.exists(path) else None
+    if old == text:
+        return True
+    if check:
+        print("%s is out of date, run tools/render_screens.py" % OUTPUT)
+        return False
+    with open(path, "w") as f:
+        f.write(text)
+    print("render_screens.py: wrote %s" % OUTPUT)
+    return True
+
+
+try:
+    Import("env")                    # noqa: F821 - run by PlatformIO
+    update(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        here = os.path.dirname(os.path.abspath(__file__))
+        sys.exit(0 if update(os.path.dirname(here), "--check" in sys.argv) else 1)
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Decode the staging panel's binary telemetry stream into a readable log.
+
+Reads 12-byte records (see include/Telemetry.h) from a serial port or a
+captured file and prints one line per record.  Bytes that do not form a
+valid record (bad sync or check byte) are skipped, so the decoder locks
+on again after noise or a partial record at the start of a capture.
+
+    telemetry_decode.py /dev/ttyACM0            # live, needs pyserial
+    telemetry_decode.py capture.bin             # from a file
+    telemetry_decode.py --raw capture.bin /dev/ttyACM0   # save while decoding
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+SYNC = 0xA5
+RECORD_SIZE = 12
+
+# keep in step with TelemetryType in include/Telemetry.h
+TYPES = {
+    1: "BOOT", 2: "FAULT", 3: "STATE", 4: "TRACK", 5: "SELECT",
+    6: "PASSBY", 7: "DIRECTION", 8: "EDGE", 9: "TASK", 10: "COUNTER",
+    11: "DROPPED", 12: "RAW_EDGE", 13: "REACTION", 14: "TRAIN",
+    15: "HOLD", 16: "RECOVERED", 17: "QUEUE", 18: "ALIGN",
+    19: "RESUME", 20: "READY", 21: "HIST", 22: "HEALTH",
+}
+STATES = ["HOUSEKEEP", "STAND_BY", "TRACK_SETUP", "TRACK_ACTIVE", "OCCUPIED"]
+DIRECTIONS = {0: "CLEAR", 1: "INBOUND", 2: "OUTBOUND"}
+# keep in step with yardInfo[] and YardSensors in src/main.cpp
+YARDS = 4
+REV_LOOPS = (True, True, True, False)
+PAIRS = dict((y * 2 + p, "y%d %s" % (y + 1, n))
+             for y in range(YARDS) for p, n in enumerate(("main", "rev")))
+SENSORS = ["y%d %s" % (y + 1, n) for y in range(YARDS)
+           for n in ("mainIn", "mainOut", "revIn", "revOut")]
+TASKS = ["sensors", "encoder", "state", "display", "stats", "link",
+         "journal", "profile"]
+COUNTERS = ["rawLost", "edgeLost", "oledBytes", "pagesSent", "pagesSkipped",
+            "tlmDropped", "linkResent", "linkBadFrames",
+            "sensorsMissed"]
+FAULTS = {1: "display missing", 2: "motor driver did not confirm a route",
+          3: "motor driver out of step, resending"}
+# keep in step with the BOOT_ milestones in include/Telemetry.h
+MILESTONES = ["sensors sampled", "state machine running", "panel showing"]
+# keep in step with TLM_HIST in include/Telemetry.h and Histogram in
+# include/Scheduler.h
+HIST_KINDS = ["run", "late", "pass"]
+HIST_BUCKETS = 16
+HIST_MIN, HIST_MAX, HIST_MISSED = 16, 17, 18
+HIST_LOOP_ID, HIST_END = 0xFF, 0xFE
+# keep in step with SensorCondition in include/SensorHealth.h and the
+# HEALTH_ items in include/Telemetry.h
+CONDITIONS = ["ok", "chatter", "stuck blocked", "stuck clear"]
+HEALTH_ITEMS = ["condition", "edges", "busiest second", "longest blocked",
+                "glitches", "window"]
+
+
+def bucket_range(b):
+    """The microseconds a Histogram bucket holds, as text."""
+    if b == 0:
+        return "0us"
+    if b == HIST_BUCKETS - 1:
+        return ">=%dus" % (1 << (b - 1))
+    lo, hi = 1 << (b - 1), (1 << b) - 1
+    return "%dus" % lo if lo == hi else "%d-%dus" % (lo, hi)
+
+
+def hist_source(rid):
+    return "loop" if rid == HIST_LOOP_ID else name(TASKS, rid)
+
+
+def name(table, i):
+    if isinstance(table, dict):
+        return table.get(i, str(i))
+    return table[i] if 0 <= i < len(table) else str(i)
+
+
+def track(yard, n):
+    rev = REV_LOOPS[yard] if 0 <= yard < YARDS else False
+    return "RevL" if rev and n == 12 else str(n)
+
+
+def describe(rtype, rid, val8, val16):
+    t = TYPES.get(rtype, "TYPE%d" % rtype)
+    if t == "BOOT":
+        return "reset cause 0x%02x" % val8
+    if t == "FAULT":
+        return name(FAULTS, rid)
+    if t == "STATE":
+        return "yard %d %s -> %s" % (rid + 1, name(STATES, val16),
+                                     name(STATES, val8))
+    if t in ("TRACK", "SELECT"):
+        return "yard %d track %s" % (rid + 1, track(rid, val8))
+    if t in ("PASSBY", "DIRECTION"):
+        return "%s %s" % (name(PAIRS, rid), name(DIRECTIONS, val8))
+    if t in ("EDGE", "RAW_EDGE"):
+        return "%s %s" % (name(SENSORS, rid), "clear" if val8 else "blocked")
+    if t == "TASK":
+        return "%s max %s %dus" % (name(TASKS, rid), "run" if val8 else "late",
+                                   val16)
+    if t == "COUNTER":
+        return "%s = %d" % (name(COUNTERS, rid), (val8 << 16) | val16)
+    if t == "DROPPED":
+        return "%d records dropped" % val16
+    if t == "REACTION":
+        return "yard %d worst reaction %dus" % (rid + 1, val16)
+    if t == "TRAIN":
+        if val8:
+            return "%s train length %dmm" % (name(PAIRS, rid), val16)
+        return "%s train speed %dmm/s" % (name(PAIRS, rid), val16)
+    if t == "HOLD":
+        return "yard %d track held %.2fs%s" % (rid + 1, val16 / 100.0,
+                                               ", fitted to the train" if val8 else "")
+    if t == "RECOVERED":
+        return "yard %d %d holds, %ds lead time recovered" % (rid + 1, val8, val16)
+    if t == "ALIGN":
+        return "yard %d %d turnouts to move, power off %dms" % (rid + 1, val8, val16)
+    if t == "READY":
+        return "%s %.1fms after reset" % (
+            name(MILESTONES, rid),
+            val16 / 10.0)
+    if t == "HIST":
+        if rid == HIST_END:
+            return "end of profile"
+        kind, slot = val8 >> 5, val8 & 0x1F
+        what = "%s %s" % (hist_source(rid), name(HIST_KINDS, kind))
+        if slot == HIST_MIN:
+            return "%s min %dus" % (what, val16)
+        if slot == HIST_MAX:
+            return "%s max %dus" % (what, val16)
+        if slot == HIST_MISSED:
+            return "%s: %d periods missed" % (hist_source(rid), val16)
+        return "%s %s x%d" % (what, bucket_range(slot), val16)
+    if t == "HEALTH":
+        what = "%s %s" % (name(SENSORS, rid), name(HEALTH_ITEMS, val8))
+        if val8 == 0:
+            return "%s %s" % (name(SENSORS, rid), name(CONDITIONS, val16))
+        if val8 == 2:
+            return "%s %d edges" % (what, val16)
+        if val8 == 3:
+            return "%s %.1fs" % (what, val16 / 10.0)
+        if val8 == 5:
+            return "%s %dus" % (what, val16)
+        return "%s %d" % (what, val16)
+    if t == "RESUME":
+        return "yard %d resumed on track %d%s%s" % (
+            rid + 1, val8, ", power on" if val16 & 1 else "",
+            ", occupied" if val16 & 2 else "")
+    if t == "QUEUE":
+        if val8 == 0:
+            return "yard %d queue flushed" % (rid + 1)
+        return "yard %d track %d queued, %d waiting" % (rid + 1, val8, val16)
+    return "id %d val8 %d val16 %d" % (rid, val8, val16)
+
+
+class Decoder:
+    """Finds records in a byte stream and unwraps the 32-bit micros()."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.last_seq = None
+        self.last_us = None
+        self.wraps = 0
+
+    def feed(self, data):
+        self.buf += data
+        while len(self.buf) >= RECORD_SIZE:
+            if self.buf[0] != SYNC:
+                del self.buf[0]
+                continue
+            rec = self.buf[:RECORD_SIZE]
+            check = 0
+            for b in rec[1:RECORD_SIZE - 1]:
+                check ^= b
+            if check != rec[RECORD_SIZE - 1]:
+                del self.buf[0]
+                continue
+            del self.buf[:RECORD_SIZE]
+            yield self.unpack(rec)
+
+    def unpack(self, rec):
+        _, rtype, seq, rid, val8, val16, us, _ = struct.unpack("<BBBBBHIB", rec)
+        gap = 0
+        if self.last_seq is not None:
+            gap = (seq - self.last_seq - 1) & 0xFF
+        self.last_seq = seq
+        if self.last_us is not None and us < self.last_us and \
+                self.last_us - us > 0x80000000:
+            self.wraps += 1
+        self.last_us = us
+        seconds = (self.wraps * 2**32 + us) / 1e6
+        return seconds, seq, gap, rtype, rid, val8, val16
+
+
+def open_source(path):
+    if os.path.exists(path) and not path.startswith("/dev/"):
+        return open(path, "rb"), False
+    import serial  # pyserial, only needed for live ports
+    return serial.Serial(path, 115200, timeout=0.2), True
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", help="serial port or captured file")
+    ap.add_argument("--raw", metavar="FILE", help="also save the raw bytes")
+    ap.add_argument("--only", metavar="TYPE", action="append",
+                    help="show only these record types (repeatable)")
+    args = ap.parse_args()
+
+    src, live = open_source(args.source)
+    raw = open(args.raw, "ab") if args.raw else None
+    only = {t.upper() for t in args.only} if args.only else None
+    dec = Decoder()
+
+    try:
+        while True:
+            data = src.read(256)
+            if not data:
+                if live:
+                    continue
+                break
+            if raw:
+                raw.write(data)
+            for seconds, seq, gap, rtype, rid, val8, val16 in dec.feed(data):
+                t = TYPES.get(rtype, "TYPE%d" % rtype)
+                if only and t not in only:
+                    continue
+                if gap:
+                    print("%14s  ---- %d record(s) missing ----" % ("", gap))
+                print("%14.6f  #%03d  %-9s  %s" % (
+                    seconds, seq, t, describe(rtype, rid, val8, val16)))
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if raw:
+            raw.close()
+
+
+if __name__ == "__main__":
+    main()
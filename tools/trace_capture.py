@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""Turn raw sensor edge telemetry into a trace for offline replay.
+
+Build the panel with -D TELEMETRY_LEVEL=4 so every raw, undebounced edge
+is sent as a RAW_EDGE record, then capture from the port (or convert an
+earlier capture saved with telemetry_decode.py --raw).  The trace format
+is described in include/sim/Trace.h; replay it with the native program:
+
+    trace_capture.py /dev/ttyACM0 yard.botr          # live, needs pyserial
+    trace_capture.py capture.bin yard.botr --marks-from-passby
+    trace_capture.py --dump yard.botr
+    .pio/build/native/program --replay yard.botr
+
+While capturing live, type a line to MARK the PassBy you just watched:
+the yard number, then "mi", "mo", "ri" or "ro" (main/rev, inbound/
+outbound), e.g. "2ro", then Enter; without a number it is yard 1.  The
+mark is placed at the last raw edge seen.  --marks-from-passby instead
+takes the panel's own PASSBY records as the expected ones, which makes a
+baseline for checking that a change to the detector still agrees.
+"""
+
+import argparse
+import queue
+import sys
+import threading
+
+from telemetry_decode import Decoder, TYPES, SENSORS, PAIRS, DIRECTIONS, \
+    open_source
+
+MAGIC = b"BOTR"
+VERSION = 2
+SENSOR_COUNT = 16
+PAIR_COUNT = 8
+MARK_KEYS = {"mi": (0, 1), "mo": (0, 2), "ri": (1, 1), "ro": (1, 2)}
+
+
+class TraceWriter:
+    """Same encoding as TraceWriter in src/sim/Trace.cpp."""
+
+    def __init__(self, f):
+        self.f = f
+        self.last = None
+        self.records = 0
+        f.write(MAGIC + bytes([VERSION, SENSOR_COUNT, 0, 0]))
+
+    def put(self, us, tag):
+        if self.last is None:
+            self.last = us
+        us = max(us, self.last)
+        v = ((us - self.last) << 6) | tag
+        self.last = us
+        out = bytearray()
+        while True:
+            b = v & 0x7F
+            v >>= 7
+            out.append(b | 0x80 if v else b)
+            if not v:
+                break
+        self.f.write(out)
+        self.records += 1
+
+    def edge(self, us, sensor, level):
+        self.put(us, ((sensor % SENSOR_COUNT) << 1) | (1 if level else 0))
+
+    def mark(self, us, pair, direction):
+        self.put(us, 32 + ((pair % PAIR_COUNT) << 1) + (1 if direction == 2 else 0))
+
+
+def read_trace(path):
+    """Yields (us, kind, id, value) with kind "EDGE" or "MARK"."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != MAGIC or not 1 <= data[4] <= VERSION:
+        raise SystemExit("%s: not a trace" % path)
+    # version 1 is one yard: 4 bit tags, marks from 8
+    bits, marks, pairs = (4, 8, 2) if data[4] == 1 else (6, 32, PAIR_COUNT)
+    now = v = shift = 0
+    for c in data[8:]:
+        v |= (c & 0x7F) << shift
+        shift += 7
+        if c & 0x80:
+            continue
+        now += v >> bits
+        tag = v & ((1 << bits) - 1)
+        if tag < marks:
+            yield now, "EDGE", tag >> 1, tag & 1
+        elif tag < marks + 2 * pairs:
+            yield now, "MARK", (tag - marks) >> 1, ((tag - marks) & 1) + 1
+        else:
+            raise SystemExit("%s: bad record at %d us" % (path, now))
+        v = shift = 0
+
+
+def dump(path):
+    edges = marks = 0
+    for us, kind, rid, value in read_trace(path):
+        if kind == "EDGE":
+            edges += 1
+            what = "%-10s %s" % (SENSORS[rid], "clear" if value else "blocked")
+        else:
+            marks += 1
+            what = "%-10s %s" % (PAIRS[rid], DIRECTIONS[value])
+        print("%14.6f  %s  %s" % (us / 1e6, kind, what))
+    print("%d edges, %d marks" % (edges, marks))
+
+
+def stdin_marks(q):
+    for line in sys.stdin:
+        key = line.strip().lower()
+        yard = 1
+        if key[:1].isdigit():
+            yard, key = int(key[0]), key[1:]
+        if key in MARK_KEYS and 1 <= yard <= PAIR_COUNT // 2:
+            pair, direction = MARK_KEYS[key]
+            q.put(((yard - 1) * 2 + pair, direction))
+        elif key:
+            print("marks are mi, mo, ri or ro, after the yard number",
+                  file=sys.stderr)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", nargs="?", help="serial port or captured file")
+    ap.add_argument("trace", nargs="?", help="trace file to write")
+    ap.add_argument("--marks-from-passby", action="store_true",
+                    help="mark every PASSBY the panel reported")
+    ap.add_argument("--dump", metavar="TRACE", help="print a trace and exit")
+    args = ap.parse_args()
+
+    if args.dump:
+        dump(args.dump)
+        return
+    if not args.source or not args.trace:
+        ap.error("need a source and a trace file")
+
+    src, live = open_source(args.source)
+    dec = Decoder()
+    marks = queue.Queue()
+    if live:
+        threading.Thread(target=stdin_marks, args=(marks,), daemon=True).start()
+
+    missing = edges = 0
+    last_us = None
+    with open(args.trace, "wb") as f:
+        out = TraceWriter(f)
+        try:
+            while True:
+                data = src.read(256)
+                if not data and not live:
+                    break
+                for seconds, seq, gap, rtype, rid, val8, val16 in dec.feed(data):
+                    missing += gap
+                    us = int(round(seconds * 1e6))
+                    t = TYPES.get(rtype)
+                    if t == "RAW_EDGE":
+                        out.edge(us, rid, val8)
+                        edges += 1
+                        last_us = us
+                    elif t == "PASSBY" and args.marks_from_passby:
+                        out.mark(us, rid, val8)
+                    elif t == "DROPPED":
+                        missing += val16
+                while last_us is not None and not marks.empty():
+                    pair, direction = marks.get()
+                    out.mark(last_us, pair, direction)
+                    print("mark %s %s" % (PAIRS[pair], DIRECTIONS[direction]))
+        except KeyboardInterrupt:
+            pass
+
+    print("%d raw edges, %d records in %s" % (edges, out.records, args.trace))
+    if not edges:
+        print("no RAW_EDGE records: is the panel built with TELEMETRY_LEVEL=4?")
+    if missing:
+        print("warning: %d telemetry records were lost, the trace has holes"
+              % missing)
+
+
+if __name__ == "__main__":
+    main()